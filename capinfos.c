@@ -59,6 +59,7 @@
 
 #include <wiretap/wtap.h>
 
+#include <wsutil/clopts_common.h>
 #include <wsutil/cmdarg_err.h>
 #include <wsutil/crash_info.h>
 #include <wsutil/filesystem.h>
@@ -156,10 +157,6 @@ static gboolean cap_file_hashes    = TRUE;  /* Calculate file hashes */
 #define HASH_BUF_SIZE (1024 * 1024)
 
 
-static gchar file_sha256[HASH_STR_SIZE];
-static gchar file_rmd160[HASH_STR_SIZE];
-static gchar file_sha1[HASH_STR_SIZE];
-
 /*
  * If we have at least two packets with time stamps, and they're not in
  * order - i.e., the later packet has a time stamp older than the earlier
@@ -212,8 +209,28 @@ typedef struct _capture_info {
   GArray               *interface_packet_counts;  /* array of per_packet interface_id counts; one entry per file IDB */
   guint32               pkt_interface_id_unknown; /* counts if packet interface_id didn't match a known one */
   GArray               *idb_info_strings;         /* array of IDB info strings */
+
+  gchar                 file_sha256[HASH_STR_SIZE];
+  gchar                 file_rmd160[HASH_STR_SIZE];
+  gchar                 file_sha1[HASH_STR_SIZE];
 } capture_info;
 
+/*
+ * One input file. Files may be processed concurrently (-j), but their
+ * reports are always printed in command-line order.
+ */
+typedef struct _capinfos_job {
+  const char           *filename;
+  gboolean              opened;                   /* the file could be opened */
+  int                   status;                   /* result of process_cap_file() */
+  gboolean              have_info;                /* cf_info holds a report to print */
+  gboolean              done;                     /* protected by jobs_mutex */
+  capture_info          cf_info;
+} capinfos_job_t;
+
+static GMutex jobs_mutex;
+static GCond  jobs_cond;
+
 static char *decimal_point;
 
 static void
@@ -693,9 +710,9 @@ print_stats(const gchar *filename, capture_info *cf_info)
     }
   }
   if (cap_file_hashes) {
-    printf     ("SHA256:              %s\n", file_sha256);
-    printf     ("RIPEMD160:           %s\n", file_rmd160);
-    printf     ("SHA1:                %s\n", file_sha1);
+    printf     ("SHA256:              %s\n", cf_info->file_sha256);
+    printf     ("RIPEMD160:           %s\n", cf_info->file_rmd160);
+    printf     ("SHA1:                %s\n", cf_info->file_sha1);
   }
   if (cap_order)          printf     ("Strict time order:   %s\n", order_string(cf_info->order));
 
@@ -949,17 +966,17 @@ print_stats_table(const gchar *filename, capture_info *cf_info)
   if (cap_file_hashes) {
     putsep();
     putquote();
-    printf("%s", file_sha256);
+    printf("%s", cf_info->file_sha256);
     putquote();
 
     putsep();
     putquote();
-    printf("%s", file_rmd160);
+    printf("%s", cf_info->file_rmd160);
     putquote();
 
     putsep();
     putquote();
-    printf("%s", file_sha1);
+    printf("%s", cf_info->file_sha1);
     putquote();
   }
 
@@ -1055,7 +1072,7 @@ cleanup_capture_info(capture_info *cf_info)
 }
 
 static int
-process_cap_file(wtap *wth, const char *filename)
+process_cap_file(wtap *wth, const char *filename, capture_info *cf_info, gboolean *have_info)
 {
   int                   status = 0;
   int                   err;
@@ -1068,7 +1085,6 @@ process_cap_file(wtap *wth, const char *filename)
   guint32               snaplen_min_inferred = 0xffffffff;
   guint32               snaplen_max_inferred =          0;
   wtap_rec             *rec;
-  capture_info          cf_info;
   gboolean              have_times = TRUE;
   nstime_t              start_time;
   int                   start_time_tsprec;
@@ -1084,6 +1100,8 @@ process_cap_file(wtap *wth, const char *filename)
   g_assert(wth != NULL);
   g_assert(filename != NULL);
 
+  *have_info = FALSE;
+
   nstime_set_zero(&start_time);
   start_time_tsprec = WTAP_TSPREC_UNKNOWN;
   nstime_set_zero(&stop_time);
@@ -1091,18 +1109,18 @@ process_cap_file(wtap *wth, const char *filename)
   nstime_set_zero(&cur_time);
   nstime_set_zero(&prev_time);
 
-  cf_info.shb = wtap_file_get_shb(wth);
+  cf_info->shb = wtap_file_get_shb(wth);
 
-  cf_info.encap_counts = g_new0(int,WTAP_NUM_ENCAP_TYPES);
+  cf_info->encap_counts = g_new0(int,WTAP_NUM_ENCAP_TYPES);
 
   idb_info = wtap_file_get_idb_info(wth);
 
   g_assert(idb_info->interface_data != NULL);
 
-  cf_info.num_interfaces = idb_info->interface_data->len;
-  cf_info.interface_packet_counts  = g_array_sized_new(FALSE, TRUE, sizeof(guint32), cf_info.num_interfaces);
-  g_array_set_size(cf_info.interface_packet_counts, cf_info.num_interfaces);
-  cf_info.pkt_interface_id_unknown = 0;
+  cf_info->num_interfaces = idb_info->interface_data->len;
+  cf_info->interface_packet_counts  = g_array_sized_new(FALSE, TRUE, sizeof(guint32), cf_info->num_interfaces);
+  g_array_set_size(cf_info->interface_packet_counts, cf_info->num_interfaces);
+  cf_info->pkt_interface_id_unknown = 0;
 
   g_free(idb_info);
   idb_info = NULL;
@@ -1154,7 +1172,7 @@ process_cap_file(wtap *wth, const char *filename)
 
       if ((rec->rec_header.packet_header.pkt_encap > 0) &&
           (rec->rec_header.packet_header.pkt_encap < WTAP_NUM_ENCAP_TYPES)) {
-        cf_info.encap_counts[rec->rec_header.packet_header.pkt_encap] += 1;
+        cf_info->encap_counts[rec->rec_header.packet_header.pkt_encap] += 1;
       } else {
         fprintf(stderr, "capinfos: Unknown packet encapsulation %d in frame %u of file \"%s\"\n",
                 rec->rec_header.packet_header.pkt_encap, packet, filename);
@@ -1162,8 +1180,8 @@ process_cap_file(wtap *wth, const char *filename)
 
       /* Packet interface_id info */
       if (rec->presence_flags & WTAP_HAS_INTERFACE_ID) {
-        /* cf_info.num_interfaces is size, not index, so it's one more than max index */
-        if (rec->rec_header.packet_header.interface_id >= cf_info.num_interfaces) {
+        /* cf_info->num_interfaces is size, not index, so it's one more than max index */
+        if (rec->rec_header.packet_header.interface_id >= cf_info->num_interfaces) {
           /*
            * OK, re-fetch the number of interfaces, as there might have
            * been an interface that was in the middle of packets, and
@@ -1172,27 +1190,27 @@ process_cap_file(wtap *wth, const char *filename)
            */
           idb_info = wtap_file_get_idb_info(wth);
 
-          cf_info.num_interfaces = idb_info->interface_data->len;
-          g_array_set_size(cf_info.interface_packet_counts, cf_info.num_interfaces);
+          cf_info->num_interfaces = idb_info->interface_data->len;
+          g_array_set_size(cf_info->interface_packet_counts, cf_info->num_interfaces);
 
           g_free(idb_info);
           idb_info = NULL;
         }
-        if (rec->rec_header.packet_header.interface_id < cf_info.num_interfaces) {
-          g_array_index(cf_info.interface_packet_counts, guint32,
+        if (rec->rec_header.packet_header.interface_id < cf_info->num_interfaces) {
+          g_array_index(cf_info->interface_packet_counts, guint32,
                         rec->rec_header.packet_header.interface_id) += 1;
         }
         else {
-          cf_info.pkt_interface_id_unknown += 1;
+          cf_info->pkt_interface_id_unknown += 1;
         }
       }
       else {
         /* it's for interface_id 0 */
-        if (cf_info.num_interfaces != 0) {
-          g_array_index(cf_info.interface_packet_counts, guint32, 0) += 1;
+        if (cf_info->num_interfaces != 0) {
+          g_array_index(cf_info->interface_packet_counts, guint32, 0) += 1;
         }
         else {
-          cf_info.pkt_interface_id_unknown += 1;
+          cf_info->pkt_interface_id_unknown += 1;
         }
       }
     }
@@ -1206,12 +1224,12 @@ process_cap_file(wtap *wth, const char *filename)
    */
   idb_info = wtap_file_get_idb_info(wth);
 
-  cf_info.idb_info_strings = g_array_sized_new(FALSE, FALSE, sizeof(gchar*), cf_info.num_interfaces);
-  cf_info.num_interfaces = idb_info->interface_data->len;
-  for (i = 0; i < cf_info.num_interfaces; i++) {
+  cf_info->idb_info_strings = g_array_sized_new(FALSE, FALSE, sizeof(gchar*), cf_info->num_interfaces);
+  cf_info->num_interfaces = idb_info->interface_data->len;
+  for (i = 0; i < cf_info->num_interfaces; i++) {
     const wtap_block_t if_descr = g_array_index(idb_info->interface_data, wtap_block_t, i);
     gchar *s = wtap_get_debug_if_descr(if_descr, 21, "\n");
-    g_array_append_val(cf_info.idb_info_strings, s);
+    g_array_append_val(cf_info->idb_info_strings, s);
   }
 
   g_free(idb_info);
@@ -1228,7 +1246,7 @@ process_cap_file(wtap *wth, const char *filename)
         fprintf(stderr,
           "  (will continue anyway, checksums might be incorrect)\n");
     } else {
-        cleanup_capture_info(&cf_info);
+        cleanup_capture_info(cf_info);
         return 1;
     }
   }
@@ -1239,72 +1257,66 @@ process_cap_file(wtap *wth, const char *filename)
     fprintf(stderr,
         "capinfos: Can't get size of \"%s\": %s.\n",
         filename, g_strerror(err));
-    cleanup_capture_info(&cf_info);
+    cleanup_capture_info(cf_info);
     return 1;
   }
 
-  cf_info.filesize = size;
+  cf_info->filesize = size;
 
   /* File Type */
-  cf_info.file_type = wtap_file_type_subtype(wth);
-  cf_info.compression_type = wtap_get_compression_type(wth);
+  cf_info->file_type = wtap_file_type_subtype(wth);
+  cf_info->compression_type = wtap_get_compression_type(wth);
 
   /* File Encapsulation */
-  cf_info.file_encap = wtap_file_encap(wth);
+  cf_info->file_encap = wtap_file_encap(wth);
 
-  cf_info.file_tsprec = wtap_file_tsprec(wth);
+  cf_info->file_tsprec = wtap_file_tsprec(wth);
 
   /* Packet size limit (snaplen) */
-  cf_info.snaplen = wtap_snapshot_length(wth);
-  if (cf_info.snaplen > 0)
-    cf_info.snap_set = TRUE;
+  cf_info->snaplen = wtap_snapshot_length(wth);
+  if (cf_info->snaplen > 0)
+    cf_info->snap_set = TRUE;
   else
-    cf_info.snap_set = FALSE;
+    cf_info->snap_set = FALSE;
 
-  cf_info.snaplen_min_inferred = snaplen_min_inferred;
-  cf_info.snaplen_max_inferred = snaplen_max_inferred;
+  cf_info->snaplen_min_inferred = snaplen_min_inferred;
+  cf_info->snaplen_max_inferred = snaplen_max_inferred;
 
   /* # of packets */
-  cf_info.packet_count = packet;
+  cf_info->packet_count = packet;
 
   /* File Times */
-  cf_info.times_known = have_times;
-  cf_info.start_time = start_time;
-  cf_info.start_time_tsprec = start_time_tsprec;
-  cf_info.stop_time = stop_time;
-  cf_info.stop_time_tsprec = stop_time_tsprec;
-  nstime_delta(&cf_info.duration, &stop_time, &start_time);
+  cf_info->times_known = have_times;
+  cf_info->start_time = start_time;
+  cf_info->start_time_tsprec = start_time_tsprec;
+  cf_info->stop_time = stop_time;
+  cf_info->stop_time_tsprec = stop_time_tsprec;
+  nstime_delta(&cf_info->duration, &stop_time, &start_time);
   /* Duration precision is the higher of the start and stop time precisions. */
-  if (cf_info.stop_time_tsprec > cf_info.start_time_tsprec)
-    cf_info.duration_tsprec = cf_info.stop_time_tsprec;
+  if (cf_info->stop_time_tsprec > cf_info->start_time_tsprec)
+    cf_info->duration_tsprec = cf_info->stop_time_tsprec;
   else
-    cf_info.duration_tsprec = cf_info.start_time_tsprec;
-  cf_info.know_order = know_order;
-  cf_info.order = order;
+    cf_info->duration_tsprec = cf_info->start_time_tsprec;
+  cf_info->know_order = know_order;
+  cf_info->order = order;
 
   /* Number of packet bytes */
-  cf_info.packet_bytes = bytes;
+  cf_info->packet_bytes = bytes;
 
-  cf_info.data_rate   = 0.0;
-  cf_info.packet_rate = 0.0;
-  cf_info.packet_size = 0.0;
+  cf_info->data_rate   = 0.0;
+  cf_info->packet_rate = 0.0;
+  cf_info->packet_size = 0.0;
 
   if (packet > 0) {
     double delta_time = nstime_to_sec(&stop_time) - nstime_to_sec(&start_time);
     if (delta_time > 0.0) {
-      cf_info.data_rate   = (double)bytes  / delta_time; /* Data rate per second */
-      cf_info.packet_rate = (double)packet / delta_time; /* packet rate per second */
+      cf_info->data_rate   = (double)bytes  / delta_time; /* Data rate per second */
+      cf_info->packet_rate = (double)packet / delta_time; /* packet rate per second */
     }
-    cf_info.packet_size = (double)bytes / packet;                  /* Avg packet size      */
-  }
-
-  if (long_report) {
-    print_stats(filename, &cf_info);
-  } else {
-    print_stats_table(filename, &cf_info);
+    cf_info->packet_size = (double)bytes / packet;                  /* Avg packet size      */
   }
 
-  cleanup_capture_info(&cf_info);
+  *have_info = TRUE;
 
   return status;
 }
@@ -1362,6 +1374,7 @@ print_usage(FILE *output)
   fprintf(output, "Miscellaneous:\n");
   fprintf(output, "  -h display this help and exit\n");
   fprintf(output, "  -C cancel processing if file open fails (default is to continue)\n");
+  fprintf(output, "  -j <jobs> process up to <jobs> files in parallel (default 1)\n");
   fprintf(output, "  -A generate all infos (default)\n");
   fprintf(output, "  -K disable displaying the capture comment\n");
   fprintf(output, "\n");
@@ -1403,15 +1416,97 @@ hash_to_str(const unsigned char *hash, size_t length, char *str) {
   }
 }
 
+/*
+ * Hash the whole file. This runs on its own thread, concurrently with
+ * the record scan of the same file in process_cap_file().
+ */
+static gpointer
+calculate_hashes(gpointer data)
+{
+  capture_info *cf_info = (capture_info *)data;
+  FILE         *fh;
+  gcry_md_hd_t  hd = NULL;
+  char         *hash_buf;
+  size_t        hash_bytes;
+
+  fh = ws_fopen(cf_info->filename, "rb");
+  if (!fh)
+    return NULL;
+
+  gcry_md_open(&hd, GCRY_MD_SHA256, 0);
+  if (hd) {
+    gcry_md_enable(hd, GCRY_MD_RMD160);
+    gcry_md_enable(hd, GCRY_MD_SHA1);
+
+    hash_buf = (char *)g_malloc(HASH_BUF_SIZE);
+    while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
+      gcry_md_write(hd, hash_buf, hash_bytes);
+    }
+    g_free(hash_buf);
+
+    gcry_md_final(hd);
+    hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, cf_info->file_sha256);
+    hash_to_str(gcry_md_read(hd, GCRY_MD_RMD160), HASH_SIZE_RMD160, cf_info->file_rmd160);
+    hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, cf_info->file_sha1);
+    gcry_md_close(hd);
+  }
+  fclose(fh);
+
+  return NULL;
+}
+
+static void
+run_capinfos_job(capinfos_job_t *job)
+{
+  GThread *hash_thread = NULL;
+  wtap    *wth;
+  int      err;
+  gchar   *err_info;
+
+  job->cf_info.filename = job->filename;
+  g_strlcpy(job->cf_info.file_sha256, "<unknown>", HASH_STR_SIZE);
+  g_strlcpy(job->cf_info.file_rmd160, "<unknown>", HASH_STR_SIZE);
+  g_strlcpy(job->cf_info.file_sha1, "<unknown>", HASH_STR_SIZE);
+
+  if (cap_file_hashes) {
+    hash_thread = g_thread_new("capinfos_hash", calculate_hashes, &job->cf_info);
+  }
+
+  wth = wtap_open_offline(job->filename, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+
+  if (!wth) {
+    cfile_open_failure_message("capinfos", job->filename, err, err_info);
+  } else {
+    job->opened = TRUE;
+    job->status = process_cap_file(wth, job->filename, &job->cf_info, &job->have_info);
+    wtap_close(wth);
+  }
+
+  if (hash_thread) {
+    g_thread_join(hash_thread);
+  }
+}
+
+/** Thread pool callback to process one file. */
+static void
+capinfos_job_callback(gpointer data, gpointer user_data _U_)
+{
+  capinfos_job_t *job = (capinfos_job_t *)data;
+
+  run_capinfos_job(job);
+
+  g_mutex_lock(&jobs_mutex);
+  job->done = TRUE;
+  g_cond_broadcast(&jobs_cond);
+  g_mutex_unlock(&jobs_mutex);
+}
+
 static int
 real_main(int argc, char *argv[])
 {
   GString *comp_info_str;
   GString *runtime_info_str;
   char  *init_progfile_dir_error;
-  wtap  *wth;
-  int    err;
-  gchar *err_info;
   int    opt;
   int    overall_error_status = EXIT_SUCCESS;
   static const struct option long_options[] = {
@@ -1420,11 +1515,11 @@ real_main(int argc, char *argv[])
       {0, 0, 0, 0 }
   };
 
-  int status = 0;
-  FILE  *fh;
-  char  *hash_buf = NULL;
-  gcry_md_hd_t hd = NULL;
-  size_t hash_bytes;
+  guint  num_jobs = 1;
+  guint  num_files = 0;
+  guint  i;
+  capinfos_job_t *jobs = NULL;
+  GThreadPool *pool = NULL;
 
   /* Set the C-language locale to the native environment. */
   setlocale(LC_ALL, "");
@@ -1477,7 +1572,7 @@ real_main(int argc, char *argv[])
   wtap_init(TRUE);
 
   /* Process the options */
-  while ((opt = getopt_long(argc, argv, "abcdehiklmoqrstuvxyzABCEFHIKLMNQRST", long_options, NULL)) !=-1) {
+  while ((opt = getopt_long(argc, argv, "abcdehij:klmoqrstuvxyzABCEFHIKLMNQRST", long_options, NULL)) !=-1) {
 
     switch (opt) {
 
@@ -1583,6 +1678,10 @@ real_main(int argc, char *argv[])
         continue_after_wtap_open_offline_failure = FALSE;
         break;
 
+      case 'j':
+        num_jobs = get_positive_int(optarg, "number of parallel jobs");
+        break;
+
       case 'A':
         enable_all_infos();
         break;
@@ -1669,62 +1768,69 @@ real_main(int argc, char *argv[])
 
   if (cap_file_hashes) {
     gcry_check_version(NULL);
-    gcry_md_open(&hd, GCRY_MD_SHA256, 0);
-    if (hd) {
-      gcry_md_enable(hd, GCRY_MD_RMD160);
-      gcry_md_enable(hd, GCRY_MD_SHA1);
-    }
-    hash_buf = (char *)g_malloc(HASH_BUF_SIZE);
   }
 
   overall_error_status = 0;
 
-  for (opt = optind; opt < argc; opt++) {
-
-    g_strlcpy(file_sha256, "<unknown>", HASH_STR_SIZE);
-    g_strlcpy(file_rmd160, "<unknown>", HASH_STR_SIZE);
-    g_strlcpy(file_sha1, "<unknown>", HASH_STR_SIZE);
+  num_files = argc - optind;
+  jobs = g_new0(capinfos_job_t, num_files);
+  for (i = 0; i < num_files; i++) {
+    jobs[i].filename = argv[optind + i];
+  }
 
-    if (cap_file_hashes) {
-      fh = ws_fopen(argv[opt], "rb");
-      if (fh && hd) {
-        while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
-          gcry_md_write(hd, hash_buf, hash_bytes);
-        }
-        gcry_md_final(hd);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, file_sha256);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_RMD160), HASH_SIZE_RMD160, file_rmd160);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, file_sha1);
-      }
-      if (fh) fclose(fh);
-      if (hd) gcry_md_reset(hd);
+  if (num_jobs > 1 && num_files > 1) {
+    pool = g_thread_pool_new(capinfos_job_callback, NULL, num_jobs, FALSE, NULL);
+    for (i = 0; i < num_files; i++) {
+      g_thread_pool_push(pool, &jobs[i], NULL);
     }
+  }
+
+  for (i = 0; i < num_files; i++) {
+    capinfos_job_t *job = &jobs[i];
 
-    wth = wtap_open_offline(argv[opt], WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+    if (pool) {
+      g_mutex_lock(&jobs_mutex);
+      while (!job->done)
+        g_cond_wait(&jobs_cond, &jobs_mutex);
+      g_mutex_unlock(&jobs_mutex);
+    } else {
+      run_capinfos_job(job);
+    }
 
-    if (!wth) {
-      cfile_open_failure_message("capinfos", argv[opt], err, err_info);
+    if (!job->opened) {
       overall_error_status = 2; /* remember that an error has occurred */
       if (!continue_after_wtap_open_offline_failure)
         goto exit;
+      continue;
     }
 
-    if (wth) {
-      if ((opt > optind) && (long_report))
-        printf("\n");
-      status = process_cap_file(wth, argv[opt]);
-
-      wtap_close(wth);
-      if (status) {
-        overall_error_status = status;
-        goto exit;
+    if ((i > 0) && (long_report))
+      printf("\n");
+    if (job->have_info) {
+      if (long_report) {
+        print_stats(job->filename, &job->cf_info);
+      } else {
+        print_stats_table(job->filename, &job->cf_info);
       }
+      cleanup_capture_info(&job->cf_info);
+      job->have_info = FALSE;
+    }
+    if (job->status) {
+      overall_error_status = job->status;
+      goto exit;
     }
   }
 
 exit:
-  g_free(hash_buf);
-  gcry_md_close(hd);
+  if (pool) {
+    /* Drop files not started yet and wait for the running ones. */
+    g_thread_pool_free(pool, TRUE, TRUE);
+  }
+  for (i = 0; i < num_files; i++) {
+    if (jobs[i].have_info)
+      cleanup_capture_info(&jobs[i].cf_info);
+  }
+  g_free(jobs);
   wtap_cleanup();
   free_progdirs();
   return overall_error_status;
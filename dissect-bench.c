@@ -0,0 +1,686 @@
+/* dissect-bench.c
+ * Replays capture files through the dissection engine and reports how
+ * fast it went and which protocols the time was spent in.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <locale.h>
+#include <errno.h>
+
+#ifdef HAVE_GETOPT_H
+#include <getopt.h>
+#endif
+
+#include <glib.h>
+
+#include <epan/epan.h>
+#include <epan/epan_dissect.h>
+#include <epan/column.h>
+#include <epan/color_filters.h>
+#include <epan/column-utils.h>
+#include <epan/packet.h>
+#include <epan/prefs.h>
+#include <epan/tap.h>
+#include <epan/timestamp.h>
+#include <epan/dfilter/dfilter.h>
+
+#ifdef HAVE_PLUGINS
+#include <wsutil/plugins.h>
+#endif
+#include <wsutil/cmdarg_err.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/json_dumper.h>
+#include <wsutil/privileges.h>
+#include <wsutil/report_message.h>
+#include <wsutil/time_util.h>
+
+#ifndef HAVE_GETOPT_LONG
+#include "wsutil/wsgetopt.h"
+#endif
+
+#include <wiretap/wtap.h>
+
+#include "ui/failure_message.h"
+
+#define PROGNAME "dissect-bench"
+
+static gboolean create_tree   = FALSE;  /* -V */
+static gboolean fill_columns  = FALSE;  /* -c */
+static gboolean colorize      = FALSE;  /* -C */
+static gboolean json_output   = FALSE;  /* -T json */
+static guint    passes        = 1;      /* -n */
+static dfilter_t *dfcode      = NULL;   /* -Y */
+static column_info cinfo;
+
+/* What each heuristic did, over all files; the dissection library resets
+   the counts whenever it's done with one. */
+typedef struct {
+	const heur_dtbl_entry_t *entry;
+	guint64 tries;
+	guint64 hits;
+} heur_count_t;
+
+static GHashTable *heur_counts;		/* heur_dtbl_entry_t * -> heur_count_t */
+
+/* Records read from the file at a time */
+#define READ_BATCH_SIZE 256
+
+typedef struct {
+	guint64 packets;
+	guint64 passed;
+	guint64 bytes;
+	gint64  elapsed_us;
+	double  user_time;
+	double  sys_time;
+} bench_totals_t;
+
+/*
+ * Just enough of a packet provider for the frame time references the
+ * dissectors ask for in a single pass.
+ */
+struct packet_provider_data {
+	const frame_data *ref;
+	const frame_data *prev_dis;
+	const frame_data *prev_cap;
+};
+
+static const nstime_t *
+bench_get_frame_ts(struct packet_provider_data *prov, guint32 frame_num)
+{
+	if (prov->ref && prov->ref->num == frame_num)
+		return &prov->ref->abs_ts;
+	if (prov->prev_dis && prov->prev_dis->num == frame_num)
+		return &prov->prev_dis->abs_ts;
+	if (prov->prev_cap && prov->prev_cap->num == frame_num)
+		return &prov->prev_cap->abs_ts;
+	return NULL;
+}
+
+static gboolean
+bench_tap_packet(void *tapdata _U_, packet_info *pinfo _U_,
+		 epan_dissect_t *edt _U_, const void *data _U_)
+{
+	return FALSE;
+}
+
+static void
+print_usage(FILE *output)
+{
+	fprintf(output, "\n");
+	fprintf(output, "Usage: " PROGNAME " [options] <infile> ...\n");
+	fprintf(output, "\n");
+	fprintf(output, "Options:\n");
+	fprintf(output, "  -V                       build the full protocol tree\n");
+	fprintf(output, "  -c                       fill in the packet list columns\n");
+	fprintf(output, "  -C                       apply the coloring rules to every packet\n");
+	fprintf(output, "  -Y <display filter>      apply a display filter to every packet\n");
+	fprintf(output, "  -t <tap>                 attach a listener to the named tap\n");
+	fprintf(output, "  -o <name>:<value> ...    override preference setting\n");
+	fprintf(output, "  -n <passes>              read the files this many times (default: 1)\n");
+	fprintf(output, "  -T text|json             output format (default: text)\n");
+	fprintf(output, "  -h                       display this help and exit\n");
+}
+
+static void
+count_heur(const gchar *table_name _U_, struct heur_dtbl_entry *entry, gpointer user_data _U_)
+{
+	heur_count_t *count;
+
+	if (entry->tries == 0)
+		return;
+	count = (heur_count_t *)g_hash_table_lookup(heur_counts, entry);
+	if (count == NULL) {
+		count = g_new0(heur_count_t, 1);
+		count->entry = entry;
+		g_hash_table_insert(heur_counts, entry, count);
+	}
+	count->tries += entry->tries;
+	count->hits += entry->hits;
+}
+
+static void
+count_heur_table(const char *table_name, struct heur_dissector_list *table _U_, gpointer user_data)
+{
+	heur_dissector_table_foreach(table_name, count_heur, user_data);
+}
+
+/*
+ * Dissect every record of one file, adding to the totals.
+ */
+static gboolean
+bench_file(const char *filename, bench_totals_t *totals)
+{
+	static const struct packet_provider_funcs funcs = {
+		bench_get_frame_ts,
+		NULL,
+		NULL,
+		NULL
+	};
+	struct packet_provider_data prov;
+	wtap           *wth;
+	epan_t         *session;
+	epan_dissect_t *edt;
+	frame_data      fdata;
+	frame_data      ref_frame;
+	frame_data      prev_dis_frame;
+	frame_data      prev_cap_frame;
+	nstime_t        elapsed_time;
+	guint32         cum_bytes = 0;
+	guint32         framenum = 0;
+	int             file_type_subtype;
+	wtap_batch      batch;
+	guint           i;
+	int             err;
+	gchar          *err_info = NULL;
+
+	wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+	if (wth == NULL) {
+		cfile_open_failure_message(PROGNAME, filename, err, err_info);
+		return FALSE;
+	}
+	file_type_subtype = wtap_file_type_subtype(wth);
+
+	memset(&prov, 0, sizeof(prov));
+	nstime_set_zero(&elapsed_time);
+	session = epan_new(&prov, &funcs);
+	edt = epan_dissect_new(session, create_tree, create_tree);
+
+	wtap_batch_init(&batch, READ_BATCH_SIZE);
+	while (wtap_read_batch(wth, &batch, &err, &err_info)) {
+		for (i = 0; i < batch.count; i++) {
+			wtap_rec *rec = &batch.recs[i].rec;
+			gboolean  passed = TRUE;
+
+			frame_data_init(&fdata, ++framenum, rec, batch.recs[i].data_offset, cum_bytes);
+
+			if (dfcode)
+				epan_dissect_prime_with_dfilter(edt, dfcode);
+			if (fill_columns)
+				col_custom_prime_edt(edt, &cinfo);
+			if (colorize)
+				color_filters_prime_edt(edt);
+
+			frame_data_set_before_dissect(&fdata, &elapsed_time, &prov.ref, prov.prev_dis);
+			if (prov.ref == &fdata) {
+				ref_frame = fdata;
+				prov.ref = &ref_frame;
+			}
+
+			epan_dissect_run_with_taps(edt, file_type_subtype, rec,
+						   tvb_new_real_data(wtap_batch_get_buf_ptr(&batch, i), fdata.cap_len, fdata.cap_len),
+						   &fdata, fill_columns ? &cinfo : NULL);
+
+			if (colorize)
+				color_filters_colorize_packet(edt);
+			if (dfcode)
+				passed = dfilter_apply_edt(dfcode, edt);
+			if (passed) {
+				frame_data_set_after_dissect(&fdata, &cum_bytes);
+				prev_dis_frame = fdata;
+				prov.prev_dis = &prev_dis_frame;
+				totals->passed++;
+			}
+			prev_cap_frame = fdata;
+			prov.prev_cap = &prev_cap_frame;
+
+			totals->packets++;
+			totals->bytes += fdata.cap_len;
+
+			epan_dissect_reset(edt);
+			frame_data_destroy(&fdata);
+		}
+	}
+	wtap_batch_cleanup(&batch);
+	if (err != 0)
+		cfile_read_failure_message(PROGNAME, filename, err, err_info);
+
+	epan_dissect_free(edt);
+	/* Add up what the heuristics did before epan_free() resets it */
+	dissector_all_heur_tables_foreach_table(count_heur_table, NULL, NULL);
+	epan_free(session);
+	wtap_close(wth);
+
+	return err == 0;
+}
+
+static void
+collect_profile(const dissector_profile_t *profile, gpointer user_data)
+{
+	g_ptr_array_add((GPtrArray *)user_data, (gpointer)profile);
+}
+
+static gint
+compare_profile_self(gconstpointer a, gconstpointer b)
+{
+	const dissector_profile_t *pa = *(const dissector_profile_t *const *)a;
+	const dissector_profile_t *pb = *(const dissector_profile_t *const *)b;
+
+	if (pa->self_us != pb->self_us)
+		return pa->self_us > pb->self_us ? -1 : 1;
+	return pa->proto_id - pb->proto_id;
+}
+
+static void
+collect_heur(gpointer key _U_, gpointer value, gpointer user_data)
+{
+	g_ptr_array_add((GPtrArray *)user_data, value);
+}
+
+static gint
+compare_heur_tries(gconstpointer a, gconstpointer b)
+{
+	const heur_count_t *ha = *(const heur_count_t *const *)a;
+	const heur_count_t *hb = *(const heur_count_t *const *)b;
+
+	if (ha->tries != hb->tries)
+		return ha->tries > hb->tries ? -1 : 1;
+	return strcmp(ha->entry->short_name, hb->entry->short_name);
+}
+
+static double
+per_second(guint64 count, gint64 elapsed_us)
+{
+	return elapsed_us > 0 ? (double)count * 1000000.0 / (double)elapsed_us : 0.0;
+}
+
+static void
+print_text(const bench_totals_t *totals, GPtrArray *profiles, GPtrArray *heurs)
+{
+	gint64 self_total = 0;
+	guint  i;
+
+	for (i = 0; i < profiles->len; i++)
+		self_total += ((const dissector_profile_t *)profiles->pdata[i])->self_us;
+
+	printf("Passes:      %u\n", passes);
+	printf("Packets:     %" G_GUINT64_FORMAT " (%" G_GUINT64_FORMAT " passed filter)\n",
+	       totals->packets, totals->passed);
+	printf("Bytes:       %" G_GUINT64_FORMAT "\n", totals->bytes);
+	printf("Elapsed:     %.3f s (user %.3f s, system %.3f s)\n",
+	       totals->elapsed_us / 1000000.0, totals->user_time, totals->sys_time);
+	printf("Packets/s:   %.1f\n", per_second(totals->packets, totals->elapsed_us));
+	printf("Bytes/s:     %.1f\n", per_second(totals->bytes, totals->elapsed_us));
+	printf("\n");
+	printf("%-24s %12s %12s %12s %7s %12s\n",
+	       "Protocol", "Calls", "Total ms", "Self ms", "Self %", "Tree items");
+	for (i = 0; i < profiles->len; i++) {
+		const dissector_profile_t *p = (const dissector_profile_t *)profiles->pdata[i];
+
+		printf("%-24s %12" G_GUINT64_FORMAT " %12.3f %12.3f %7.2f %12" G_GUINT64_FORMAT "\n",
+		       proto_get_protocol_filter_name(p->proto_id), p->calls,
+		       p->total_us / 1000.0, p->self_us / 1000.0,
+		       self_total > 0 ? 100.0 * p->self_us / self_total : 0.0,
+		       p->tree_items);
+	}
+
+	if (heurs->len == 0)
+		return;
+	printf("\n");
+	printf("%-24s %-12s %12s %12s %7s\n",
+	       "Heuristic", "List", "Tries", "Hits", "Hit %");
+	for (i = 0; i < heurs->len; i++) {
+		const heur_count_t *h = (const heur_count_t *)heurs->pdata[i];
+
+		printf("%-24s %-12s %12" G_GUINT64_FORMAT " %12" G_GUINT64_FORMAT " %7.2f\n",
+		       h->entry->short_name, h->entry->list_name, h->tries, h->hits,
+		       100.0 * h->hits / h->tries);
+	}
+}
+
+static void
+print_json(const bench_totals_t *totals, GPtrArray *profiles, GPtrArray *heurs)
+{
+	json_dumper dumper = {
+		.output_file = stdout,
+		.flags = JSON_DUMPER_FLAGS_PRETTY_PRINT,
+	};
+	guint i;
+
+	json_dumper_begin_object(&dumper);
+	json_dumper_set_member_name(&dumper, "version");
+	json_dumper_value_string(&dumper, epan_get_version());
+	json_dumper_set_member_name(&dumper, "passes");
+	json_dumper_value_anyf(&dumper, "%u", passes);
+	json_dumper_set_member_name(&dumper, "packets");
+	json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, totals->packets);
+	json_dumper_set_member_name(&dumper, "passed");
+	json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, totals->passed);
+	json_dumper_set_member_name(&dumper, "bytes");
+	json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, totals->bytes);
+	json_dumper_set_member_name(&dumper, "elapsed_us");
+	json_dumper_value_anyf(&dumper, "%" G_GINT64_FORMAT, totals->elapsed_us);
+	json_dumper_set_member_name(&dumper, "user_s");
+	json_dumper_value_anyf(&dumper, "%.6f", totals->user_time);
+	json_dumper_set_member_name(&dumper, "system_s");
+	json_dumper_value_anyf(&dumper, "%.6f", totals->sys_time);
+	json_dumper_set_member_name(&dumper, "packets_per_s");
+	json_dumper_value_anyf(&dumper, "%.1f", per_second(totals->packets, totals->elapsed_us));
+	json_dumper_set_member_name(&dumper, "bytes_per_s");
+	json_dumper_value_anyf(&dumper, "%.1f", per_second(totals->bytes, totals->elapsed_us));
+
+	json_dumper_set_member_name(&dumper, "protocols");
+	json_dumper_begin_array(&dumper);
+	for (i = 0; i < profiles->len; i++) {
+		const dissector_profile_t *p = (const dissector_profile_t *)profiles->pdata[i];
+
+		json_dumper_begin_object(&dumper);
+		json_dumper_set_member_name(&dumper, "protocol");
+		json_dumper_value_string(&dumper, proto_get_protocol_filter_name(p->proto_id));
+		json_dumper_set_member_name(&dumper, "calls");
+		json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, p->calls);
+		json_dumper_set_member_name(&dumper, "total_us");
+		json_dumper_value_anyf(&dumper, "%" G_GINT64_FORMAT, p->total_us);
+		json_dumper_set_member_name(&dumper, "self_us");
+		json_dumper_value_anyf(&dumper, "%" G_GINT64_FORMAT, p->self_us);
+		json_dumper_set_member_name(&dumper, "tree_items");
+		json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, p->tree_items);
+		json_dumper_end_object(&dumper);
+	}
+	json_dumper_end_array(&dumper);
+
+	json_dumper_set_member_name(&dumper, "heuristics");
+	json_dumper_begin_array(&dumper);
+	for (i = 0; i < heurs->len; i++) {
+		const heur_count_t *h = (const heur_count_t *)heurs->pdata[i];
+
+		json_dumper_begin_object(&dumper);
+		json_dumper_set_member_name(&dumper, "heuristic");
+		json_dumper_value_string(&dumper, h->entry->short_name);
+		json_dumper_set_member_name(&dumper, "list");
+		json_dumper_value_string(&dumper, h->entry->list_name);
+		json_dumper_set_member_name(&dumper, "tries");
+		json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, h->tries);
+		json_dumper_set_member_name(&dumper, "hits");
+		json_dumper_value_anyf(&dumper, "%" G_GUINT64_FORMAT, h->hits);
+		json_dumper_end_object(&dumper);
+	}
+	json_dumper_end_array(&dumper);
+	json_dumper_end_object(&dumper);
+	json_dumper_finish(&dumper);
+}
+
+/*
+ * General errors and warnings are reported with an console message
+ * in "dissect-bench".
+ */
+static void
+failure_warning_message(const char *msg_format, va_list ap)
+{
+	fprintf(stderr, PROGNAME ": ");
+	vfprintf(stderr, msg_format, ap);
+	fprintf(stderr, "\n");
+}
+
+/*
+ * Open/create errors are reported with an console message in "dissect-bench".
+ */
+static void
+open_failure_message(const char *filename, int err, gboolean for_writing)
+{
+	fprintf(stderr, PROGNAME ": ");
+	fprintf(stderr, file_open_error_message(err, for_writing), filename);
+	fprintf(stderr, "\n");
+}
+
+/*
+ * Read errors are reported with an console message in "dissect-bench".
+ */
+static void
+read_failure_message(const char *filename, int err)
+{
+	fprintf(stderr, PROGNAME ": An error occurred while reading from the file \"%s\": %s.\n",
+		filename, g_strerror(err));
+}
+
+/*
+ * Write errors are reported with an console message in "dissect-bench".
+ */
+static void
+write_failure_message(const char *filename, int err)
+{
+	fprintf(stderr, PROGNAME ": An error occurred while writing to the file \"%s\": %s.\n",
+		filename, g_strerror(err));
+}
+
+/*
+ * Report additional information for an error in command-line arguments.
+ */
+static void
+failure_message_cont(const char *msg_format, va_list ap)
+{
+	vfprintf(stderr, msg_format, ap);
+	fprintf(stderr, "\n");
+}
+
+int
+main(int argc, char **argv)
+{
+	char          *init_progfile_dir_error;
+	e_prefs       *prefs_p;
+	GPtrArray     *taps;
+	GPtrArray     *profiles;
+	GPtrArray     *heurs;
+	const char    *dfilter_text = NULL;
+	gchar         *err_msg;
+	GString       *tap_error;
+	bench_totals_t totals;
+	guint          tap_flags;
+	guint          pass;
+	int            opt;
+	int            i;
+	int            ret = 0;
+
+	cmdarg_err_init(failure_warning_message, failure_message_cont);
+
+	/*
+	 * Get credential information for later use.
+	 */
+	init_process_policies();
+
+	/*
+	 * Attempt to get the pathname of the directory containing the
+	 * executable file.
+	 */
+	init_progfile_dir_error = init_progfile_dir(argv[0]);
+	if (init_progfile_dir_error != NULL) {
+		fprintf(stderr, PROGNAME ": Can't get pathname of directory containing the " PROGNAME " program: %s.\n",
+			init_progfile_dir_error);
+		g_free(init_progfile_dir_error);
+	}
+
+	init_report_message(failure_warning_message, failure_warning_message,
+			    open_failure_message, read_failure_message,
+			    write_failure_message);
+
+	timestamp_set_type(TS_RELATIVE);
+	timestamp_set_precision(TS_PREC_AUTO);
+	timestamp_set_seconds_type(TS_SECONDS_DEFAULT);
+
+	wtap_init(TRUE);
+
+	if (!epan_init(NULL, NULL, TRUE))
+		return 2;
+
+	/* set the c-language locale to the native environment. */
+	setlocale(LC_ALL, "");
+
+	/* Load libwireshark settings from the current profile. */
+	prefs_p = epan_load_settings();
+
+	taps = g_ptr_array_new();
+	while ((opt = getopt(argc, argv, "cChn:o:t:T:VY:")) != -1) {
+		switch (opt) {
+		case 'c':
+			fill_columns = TRUE;
+			break;
+		case 'C':
+			colorize = TRUE;
+			break;
+		case 'h':
+			print_usage(stdout);
+			exit(0);
+		case 'n':
+			passes = (guint)strtoul(optarg, NULL, 10);
+			if (passes == 0) {
+				cmdarg_err("The number of passes must be at least 1.");
+				exit(1);
+			}
+			break;
+		case 'o':
+			switch (prefs_set_pref(optarg, &err_msg)) {
+			case PREFS_SET_OK:
+				break;
+			case PREFS_SET_SYNTAX_ERR:
+				cmdarg_err("Invalid -o flag \"%s\"%s%s", optarg,
+					   err_msg ? ": " : "", err_msg ? err_msg : "");
+				g_free(err_msg);
+				exit(1);
+			case PREFS_SET_NO_SUCH_PREF:
+			case PREFS_SET_OBSOLETE:
+				cmdarg_err("-o flag \"%s\" specifies unknown preference", optarg);
+				exit(1);
+			}
+			break;
+		case 't':
+			g_ptr_array_add(taps, optarg);
+			break;
+		case 'T':
+			if (strcmp(optarg, "json") == 0)
+				json_output = TRUE;
+			else if (strcmp(optarg, "text") == 0)
+				json_output = FALSE;
+			else {
+				cmdarg_err("Invalid -T parameter \"%s\"; it must be \"text\" or \"json\".", optarg);
+				exit(1);
+			}
+			break;
+		case 'V':
+			create_tree = TRUE;
+			break;
+		case 'Y':
+			dfilter_text = optarg;
+			break;
+		default:
+			print_usage(stderr);
+			exit(1);
+		}
+	}
+	if (optind >= argc) {
+		print_usage(stderr);
+		exit(1);
+	}
+
+	/* notify all registered modules that have had any of their preferences
+	changed either from one of the preferences file or from the command
+	line that its preferences have changed. */
+	prefs_apply_all();
+
+	if (dfilter_text && !dfilter_compile(dfilter_text, &dfcode, &err_msg)) {
+		cmdarg_err("%s", err_msg);
+		g_free(err_msg);
+		exit(1);
+	}
+
+	if (colorize && !color_filters_init(&err_msg, NULL)) {
+		cmdarg_err("%s", err_msg);
+		g_free(err_msg);
+		exit(1);
+	}
+
+	for (i = 0; i < (int)taps->len; i++) {
+		tap_error = register_tap_listener((const char *)taps->pdata[i], taps->pdata[i], NULL,
+						  TL_REQUIRES_NOTHING, NULL, bench_tap_packet, NULL, NULL);
+		if (tap_error) {
+			cmdarg_err("Couldn't register a listener on tap \"%s\": %s",
+				   (const char *)taps->pdata[i], tap_error->str);
+			g_string_free(tap_error, TRUE);
+			exit(1);
+		}
+	}
+
+	/* Whatever the taps need has to be produced, or we'd measure less
+	   than a real run with them would do. */
+	tap_flags = union_of_tap_listener_flags();
+	if (tap_flags & TL_REQUIRES_PROTO_TREE)
+		create_tree = TRUE;
+	if (tap_flags & TL_REQUIRES_COLUMNS)
+		fill_columns = TRUE;
+	if (dfcode || colorize)
+		create_tree = TRUE;
+
+	if (fill_columns)
+		build_column_format_array(&cinfo, prefs_p->num_cols, TRUE);
+
+	memset(&totals, 0, sizeof(totals));
+	heur_counts = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+	dissector_profile_enable(TRUE);
+	for (pass = 0; pass < passes && ret == 0; pass++) {
+		double  start_user, start_sys, end_user, end_sys;
+		gint64  start = g_get_monotonic_time();
+
+		get_resource_usage(&start_user, &start_sys);
+		for (i = optind; i < argc; i++) {
+			if (!bench_file(argv[i], &totals))
+				ret = 2;
+		}
+		get_resource_usage(&end_user, &end_sys);
+
+		totals.elapsed_us += g_get_monotonic_time() - start;
+		totals.user_time += end_user - start_user;
+		totals.sys_time += end_sys - start_sys;
+	}
+	dissector_profile_enable(FALSE);
+
+	profiles = g_ptr_array_new();
+	dissector_profile_foreach(collect_profile, profiles);
+	g_ptr_array_sort(profiles, compare_profile_self);
+
+	heurs = g_ptr_array_new();
+	g_hash_table_foreach(heur_counts, collect_heur, heurs);
+	g_ptr_array_sort(heurs, compare_heur_tries);
+
+	if (json_output)
+		print_json(&totals, profiles, heurs);
+	else
+		print_text(&totals, profiles, heurs);
+
+	g_ptr_array_free(profiles, TRUE);
+	g_ptr_array_free(heurs, TRUE);
+	g_hash_table_destroy(heur_counts);
+	for (i = 0; i < (int)taps->len; i++)
+		remove_tap_listener(taps->pdata[i]);
+	g_ptr_array_free(taps, TRUE);
+	dfilter_free(dfcode);
+	if (colorize)
+		color_filters_cleanup();
+	if (fill_columns)
+		col_cleanup(&cinfo);
+	epan_cleanup();
+	wtap_cleanup();
+	free_progdirs();
+
+	return ret;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -489,7 +489,7 @@ sync_lookup_ip6(const ws_in6_addr *addr)
     sdd->family = AF_INET6;
     memcpy(&sdd->addr.ip6, addr, sizeof(sdd->addr.ip6));
     sdd->completed = &completed;
-    ares_gethostbyaddr(ghba_chan, &addr, sizeof(ws_in6_addr), AF_INET6,
+    ares_gethostbyaddr(ghba_chan, addr, sizeof(ws_in6_addr), AF_INET6,
                        c_ares_ghba_sync_cb, sdd);
 
     /*
@@ -2737,22 +2737,15 @@ disable_name_resolution(void) {
 }
 
 #ifdef HAVE_C_ARES
-gboolean
-host_name_lookup_process(void) {
+/*
+ * Hand queued asynchronous lookups to c-ares, keeping no more than
+ * name_resolve_concurrency of them in flight.
+ */
+static void
+submit_queued_lookups(void) {
     async_dns_queue_msg_t *caqm;
-    struct timeval tv = { 0, 0 };
-    int nfds;
-    fd_set rfds, wfds;
-    gboolean nro = new_resolved_objects;
     wmem_list_frame_t* head;
 
-    new_resolved_objects = FALSE;
-    nro |= maxmind_db_lookup_process();
-
-    if (!async_dns_initialized)
-        /* c-ares not initialized. Bail out and cancel timers. */
-        return nro;
-
     head = wmem_list_head(async_dns_queue_head);
 
     while (head != NULL && async_dns_in_flight <= name_resolve_concurrency) {
@@ -2770,6 +2763,23 @@ host_name_lookup_process(void) {
 
         head = wmem_list_head(async_dns_queue_head);
     }
+}
+
+gboolean
+host_name_lookup_process(void) {
+    struct timeval tv = { 0, 0 };
+    int nfds;
+    fd_set rfds, wfds;
+    gboolean nro = new_resolved_objects;
+
+    new_resolved_objects = FALSE;
+    nro |= maxmind_db_lookup_process();
+
+    if (!async_dns_initialized)
+        /* c-ares not initialized. Bail out and cancel timers. */
+        return nro;
+
+    submit_queued_lookups();
 
     FD_ZERO(&rfds);
     FD_ZERO(&wfds);
@@ -2786,6 +2796,50 @@ host_name_lookup_process(void) {
     return nro;
 }
 
+gboolean
+host_name_lookup_wait(void) {
+    struct timeval tv, *tvp;
+    int nfds;
+    fd_set rfds, wfds;
+    gboolean nro;
+
+    nro = host_name_lookup_process();
+
+    if (!async_dns_initialized)
+        return nro;
+
+    /*
+     * Keep the pipeline full until both the queue and the set of
+     * requests in flight have drained.  c-ares reports every request,
+     * including ones that fail or time out, through c_ares_ghba_cb,
+     * so async_dns_in_flight always gets back to zero.
+     */
+    while (async_dns_in_flight > 0 || wmem_list_count(async_dns_queue_head) > 0) {
+        submit_queued_lookups();
+
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        nfds = ares_fds(ghba_chan, &rfds, &wfds);
+        if (nfds == 0) {
+            /* Nothing outstanding on the channel; nothing to wait for. */
+            break;
+        }
+        tv.tv_sec = 1;
+        tv.tv_usec = 0;
+        tvp = ares_timeout(ghba_chan, &tv, &tv);
+        if (select(nfds, &rfds, &wfds, NULL, tvp) == -1) { /* call to select() failed */
+            fprintf(stderr, "Warning: call to select() failed, error is %s\n", g_strerror(errno));
+            break;
+        }
+        ares_process(ghba_chan, &rfds, &wfds);
+    }
+
+    nro |= new_resolved_objects;
+    new_resolved_objects = FALSE;
+
+    return nro;
+}
+
 static void
 _host_name_lookup_cleanup(void) {
     async_dns_queue_head = NULL;
@@ -2813,6 +2867,11 @@ host_name_lookup_process(void) {
     return nro;
 }
 
+gboolean
+host_name_lookup_wait(void) {
+    return host_name_lookup_process();
+}
+
 static void
 _host_name_lookup_cleanup(void) {
 }
@@ -189,6 +189,17 @@ WS_DLL_PUBLIC void disable_name_resolution(void);
  */
 WS_DLL_PUBLIC gboolean host_name_lookup_process(void);
 
+/** If we're using c-ares, submit every queued host name lookup, keeping
+ *  no more than the configured number of requests in flight, and wait
+ *  until all of them have been answered or have timed out.
+ *  This lets TShark resolve the addresses collected during its first
+ *  pass in bulk instead of blocking on each one during the second pass.
+ *
+ * @return True if any new objects have been resolved since the previous
+ * call.
+ */
+WS_DLL_PUBLIC gboolean host_name_lookup_wait(void);
+
 /* get_hostname returns the host name or "%d.%d.%d.%d" if not found */
 WS_DLL_PUBLIC const gchar *get_hostname(const guint addr);
 
@@ -43,6 +43,11 @@ static GSList *color_filter_list = NULL;
 static GSList *color_filter_deleted_list = NULL;
 static GSList *color_filter_valid_list   = NULL;
 
+/* Scratch arrays for color_filters_colorize_packet(), reused from packet
+ * to packet. */
+static GPtrArray *active_filters = NULL;
+static GPtrArray *active_dfilters = NULL;
+
 /* Color Filters can en-/disabled. */
 static gboolean filters_enabled = TRUE;
 
@@ -347,6 +352,13 @@ color_filters_cleanup(void)
 {
     /* delete the previously deleted filters */
     color_filter_list_delete(&color_filter_deleted_list);
+
+    if (active_filters != NULL) {
+        g_ptr_array_free(active_filters, TRUE);
+        g_ptr_array_free(active_dfilters, TRUE);
+        active_filters = NULL;
+        active_dfilters = NULL;
+    }
 }
 
 typedef struct _color_clone
@@ -494,19 +506,34 @@ color_filters_colorize_packet(epan_dissect_t *edt)
 {
     GSList         *curr;
     color_filter_t *colorf;
+    int             match;
 
     /* If we have color filters, "search" for the matching one. */
     if ((edt->tree != NULL) && (color_filters_used())) {
-        curr = color_filter_list;
+        if (active_filters == NULL) {
+            active_filters = g_ptr_array_new();
+            active_dfilters = g_ptr_array_new();
+        }
+        g_ptr_array_set_size(active_filters, 0);
+        g_ptr_array_set_size(active_dfilters, 0);
 
-        while(curr != NULL) {
+        /*
+         * Apply all of the enabled filters as one batch, so that fields
+         * tested by several of them are only read from the tree once.
+         */
+        for (curr = color_filter_list; curr != NULL; curr = g_slist_next(curr)) {
             colorf = (color_filter_t *)curr->data;
             if ( (!colorf->disabled) &&
-                 (colorf->c_colorfilter != NULL) &&
-                 dfilter_apply_edt(colorf->c_colorfilter, edt)) {
-                return colorf;
+                 (colorf->c_colorfilter != NULL) ) {
+                g_ptr_array_add(active_filters, colorf);
+                g_ptr_array_add(active_dfilters, colorf->c_colorfilter);
             }
-            curr = g_slist_next(curr);
+        }
+
+        match = dfilter_apply_first_edt((dfilter_t **)active_dfilters->pdata,
+                                        active_dfilters->len, edt);
+        if (match >= 0) {
+            return (color_filter_t *)g_ptr_array_index(active_filters, match);
         }
     }
 
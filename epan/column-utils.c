@@ -489,7 +489,7 @@ col_do_append_fstr(column_info *cinfo, const int el, const char *separator, cons
        * If we have a separator, append it if the column isn't empty.
        */
       if (sep_len != 0 && len != 0) {
-        g_strlcat(col_item->col_buf, separator, max_len);
+        g_strlcpy(&col_item->col_buf[len], separator, max_len - len);
         len += sep_len;
       }
 
@@ -538,22 +538,24 @@ col_append_sep_fstr(column_info *cinfo, const gint el, const gchar *separator,
   va_end(ap);
 }
 
-/* Prepends a vararg list to a packet info string. */
 #define COL_BUF_MAX_LEN (((COL_MAX_INFO_LEN) > (COL_MAX_LEN)) ? \
     (COL_MAX_INFO_LEN) : (COL_MAX_LEN))
-void
-col_prepend_fstr(column_info *cinfo, const gint el, const gchar *format, ...)
+
+/*
+ * Prepends a vararg list to a packet info string. The text is formatted
+ * once, however many columns it goes into, and spliced in front of the
+ * existing text in place.
+ */
+static void
+col_do_prepend_fstr(column_info *cinfo, const gint el, gboolean add_fence, const gchar *format, va_list ap)
 {
-  va_list     ap;
   int         i;
-  char        orig_buf[COL_BUF_MAX_LEN];
-  const char *orig;
-  int         max_len;
+  char        prefix[COL_BUF_MAX_LEN];
+  size_t      prefix_len = 0, orig_len;
+  gboolean    formatted = FALSE;
+  size_t      max_len;
   col_item_t* col_item;
 
-  if (!CHECK_COL(cinfo, el))
-    return;
-
   if (el == COL_INFO)
     max_len = COL_MAX_INFO_LEN;
   else
@@ -562,73 +564,63 @@ col_prepend_fstr(column_info *cinfo, const gint el, const gchar *format, ...)
   for (i = cinfo->col_first[el]; i <= cinfo->col_last[el]; i++) {
     col_item = &cinfo->columns[i];
     if (col_item->fmt_matx[el]) {
+      if (!formatted) {
+        ws_vsnprintf(prefix, max_len, format, ap);
+        prefix_len = strlen(prefix);
+        formatted = TRUE;
+      }
+
+      /* Whatever no longer fits after the prefix is cut off. */
       if (col_item->col_data != col_item->col_buf) {
         /* This was set with "col_set_str()"; which is effectively const */
-        orig = col_item->col_data;
+        orig_len = MIN(strlen(col_item->col_data), max_len - 1 - prefix_len);
+        memcpy(&col_item->col_buf[prefix_len], col_item->col_data, orig_len);
       } else {
-        g_strlcpy(orig_buf, col_item->col_buf, max_len);
-        orig = orig_buf;
+        orig_len = MIN(strlen(col_item->col_buf), max_len - 1 - prefix_len);
+        memmove(&col_item->col_buf[prefix_len], col_item->col_buf, orig_len);
       }
-      va_start(ap, format);
-      ws_vsnprintf(col_item->col_buf, max_len, format, ap);
-      va_end(ap);
+      memcpy(col_item->col_buf, prefix, prefix_len);
+      col_item->col_buf[prefix_len + orig_len] = '\0';
 
       /*
-       * Move the fence, unless it's at the beginning of the string.
+       * Move the fence if it exists, else create a new fence at the
+       * end of the prepended data if asked to.
        */
-      if (col_item->col_fence > 0)
-        col_item->col_fence += (int) strlen(col_item->col_buf);
-
-      g_strlcat(col_item->col_buf, orig, max_len);
+      if (col_item->col_fence > 0) {
+        col_item->col_fence += (int) prefix_len;
+      } else if (add_fence) {
+        col_item->col_fence = (int) prefix_len;
+      }
       col_item->col_data = col_item->col_buf;
     }
   }
 }
+
+/* Prepends a vararg list to a packet info string. */
 void
-col_prepend_fence_fstr(column_info *cinfo, const gint el, const gchar *format, ...)
+col_prepend_fstr(column_info *cinfo, const gint el, const gchar *format, ...)
 {
-  va_list     ap;
-  int         i;
-  char        orig_buf[COL_BUF_MAX_LEN];
-  const char *orig;
-  int         max_len;
-  col_item_t* col_item;
+  va_list ap;
 
   if (!CHECK_COL(cinfo, el))
     return;
 
-  if (el == COL_INFO)
-    max_len = COL_MAX_INFO_LEN;
-  else
-    max_len = COL_MAX_LEN;
+  va_start(ap, format);
+  col_do_prepend_fstr(cinfo, el, FALSE, format, ap);
+  va_end(ap);
+}
 
-  for (i = cinfo->col_first[el]; i <= cinfo->col_last[el]; i++) {
-    col_item = &cinfo->columns[i];
-    if (col_item->fmt_matx[el]) {
-      if (col_item->col_data != col_item->col_buf) {
-        /* This was set with "col_set_str()"; which is effectively const */
-        orig = col_item->col_data;
-      } else {
-        g_strlcpy(orig_buf, col_item->col_buf, max_len);
-        orig = orig_buf;
-      }
-      va_start(ap, format);
-      ws_vsnprintf(col_item->col_buf, max_len, format, ap);
-      va_end(ap);
+void
+col_prepend_fence_fstr(column_info *cinfo, const gint el, const gchar *format, ...)
+{
+  va_list ap;
 
-      /*
-       * Move the fence if it exists, else create a new fence at the
-       * end of the prepended data.
-       */
-      if (col_item->col_fence > 0) {
-        col_item->col_fence += (int) strlen(col_item->col_buf);
-      } else {
-        col_item->col_fence = (int) strlen(col_item->col_buf);
-      }
-      g_strlcat(col_item->col_buf, orig, max_len);
-      col_item->col_data = col_item->col_buf;
-    }
-  }
+  if (!CHECK_COL(cinfo, el))
+    return;
+
+  va_start(ap, format);
+  col_do_prepend_fstr(cinfo, el, TRUE, format, ap);
+  va_end(ap);
 }
 
 /* Use this if "str" points to something that won't stay around (and
@@ -818,17 +810,16 @@ col_do_append_str(column_info *cinfo, const gint el, const gchar* separator,
        */
       COL_CHECK_APPEND(col_item, max_len);
 
-      len = col_item->col_buf[0];
+      len = strlen(col_item->col_buf);
 
       /*
        * If we have a separator, append it if the column isn't empty.
        */
-      if (separator != NULL) {
-        if (len != 0) {
-          g_strlcat(col_item->col_buf, separator, max_len);
-        }
+      if (separator != NULL && len != 0) {
+        len += g_strlcpy(&col_item->col_buf[len], separator, max_len - len);
       }
-      g_strlcat(col_item->col_buf, str, max_len);
+      if (len < max_len)
+        g_strlcpy(&col_item->col_buf[len], str, max_len - len);
     }
   }
 }
@@ -872,118 +863,165 @@ col_has_time_fmt(column_info *cinfo, const gint col)
           (col_item->fmt_matx[COL_DELTA_TIME_DIS]));
 }
 
-static void
-set_abs_ymd_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
+typedef enum {
+  ABS_TIME_HMS,     /* hh:mm:ss */
+  ABS_TIME_YMD,     /* YYYY-MM-DD hh:mm:ss */
+  ABS_TIME_YDOY,    /* YYYY/DOY hh:mm:ss */
+  ABS_TIME_NUM_STYLES
+} abs_time_style_e;
+
+/*
+ * The whole-second part of the most recently formatted absolute time,
+ * per style and per local/UTC. Consecutive frames almost always fall in
+ * the same second, so this saves a localtime()/gmtime() and a
+ * ws_snprintf() call for nearly every row.
+ */
+typedef struct {
+  gboolean valid;
+  time_t   secs;
+  gsize    len;
+  gchar    text[48];
+} abs_time_cache_t;
+
+static abs_time_cache_t abs_time_cache[ABS_TIME_NUM_STYLES][2];
+
+static int
+abs_time_precision(const frame_data *fd)
 {
+  switch (timestamp_get_precision()) {
+  case TS_PREC_FIXED_SEC:
+    return WTAP_TSPREC_SEC;
+  case TS_PREC_FIXED_DSEC:
+    return WTAP_TSPREC_DSEC;
+  case TS_PREC_FIXED_CSEC:
+    return WTAP_TSPREC_CSEC;
+  case TS_PREC_FIXED_MSEC:
+    return WTAP_TSPREC_MSEC;
+  case TS_PREC_FIXED_USEC:
+    return WTAP_TSPREC_USEC;
+  case TS_PREC_FIXED_NSEC:
+    return WTAP_TSPREC_NSEC;
+  case TS_PREC_AUTO:
+    return fd->tsprec;
+  default:
+    g_assert_not_reached();
+  }
+  return WTAP_TSPREC_SEC;
+}
+
+/*
+ * Returns the cache entry holding the whole-second text for "then", or
+ * NULL if the time can't be converted.
+ */
+static const abs_time_cache_t *
+abs_time_seconds(time_t then, abs_time_style_e style, gboolean local)
+{
+  abs_time_cache_t *entry = &abs_time_cache[style][local ? 1 : 0];
   struct tm *tmp;
-  time_t then;
-  int tsprecision;
 
-  if (fd->flags.has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      g_assert_not_reached();
+  if (entry->valid && entry->secs == then)
+    return entry;
+
+  if (local)
+    tmp = localtime(&then);
+  else
+    tmp = gmtime(&then);
+  if (tmp == NULL)
+    return NULL;
+
+  switch (style) {
+  case ABS_TIME_YMD:
+    ws_snprintf(entry->text, sizeof entry->text, "%04d-%02d-%02d %02d:%02d:%02d",
+      tmp->tm_year + 1900,
+      tmp->tm_mon + 1,
+      tmp->tm_mday,
+      tmp->tm_hour,
+      tmp->tm_min,
+      tmp->tm_sec);
+    break;
+  case ABS_TIME_YDOY:
+    ws_snprintf(entry->text, sizeof entry->text, "%04d/%03d %02d:%02d:%02d",
+      tmp->tm_year + 1900,
+      tmp->tm_yday + 1,
+      tmp->tm_hour,
+      tmp->tm_min,
+      tmp->tm_sec);
+    break;
+  case ABS_TIME_HMS:
+  default:
+    ws_snprintf(entry->text, sizeof entry->text, "%02d:%02d:%02d",
+      tmp->tm_hour,
+      tmp->tm_min,
+      tmp->tm_sec);
+    break;
+  }
+
+  entry->valid = TRUE;
+  entry->secs = then;
+  entry->len = strlen(entry->text);
+  return entry;
+}
+
+static void
+set_abs_time_style(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local, abs_time_style_e style)
+{
+  /* Divisor that leaves n fraction digits of a nanosecond count. */
+  static const int frac_divisor[] = {
+    1000000000, 100000000, 10000000, 1000000, 100000,
+    10000, 1000, 100, 10, 1
+  };
+  const abs_time_cache_t *secs_text;
+  gsize len, dp_len;
+  int tsprecision, ndigits, frac, i;
+
+  if (!fd->flags.has_ts ||
+      (secs_text = abs_time_seconds(fd->abs_ts.secs, style, local)) == NULL) {
+    buf[0] = '\0';
+    return;
+  }
+
+  memcpy(buf, secs_text->text, secs_text->len);
+  len = secs_text->len;
+
+  tsprecision = abs_time_precision(fd);
+  switch (tsprecision) {
+  case WTAP_TSPREC_SEC:
+  case WTAP_TSPREC_DSEC:
+  case WTAP_TSPREC_CSEC:
+  case WTAP_TSPREC_MSEC:
+  case WTAP_TSPREC_USEC:
+  case WTAP_TSPREC_NSEC:
+    break;
+  default:
+    g_assert_not_reached();
+  }
+  /* The WTAP_TSPREC_ values are the number of fraction digits. */
+  ndigits = tsprecision;
+
+  if (ndigits != 0) {
+    dp_len = strlen(decimal_point);
+    if (len + dp_len + ndigits >= COL_MAX_LEN) {
+      buf[len] = '\0';
+      return;
     }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%03d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%09d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
+    memcpy(&buf[len], decimal_point, dp_len);
+    len += dp_len;
+
+    /* Write the zero-padded fraction right to left. */
+    frac = fd->abs_ts.nsecs / frac_divisor[ndigits];
+    for (i = ndigits - 1; i >= 0; i--) {
+      buf[len + i] = '0' + (frac % 10);
+      frac /= 10;
     }
-  } else {
-    buf[0] = '\0';
+    len += ndigits;
   }
+  buf[len] = '\0';
+}
+
+static void
+set_abs_ymd_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
+{
+  set_abs_time_style(fd, buf, decimal_point, local, ABS_TIME_YMD);
 }
 
 static void
@@ -1009,109 +1047,7 @@ col_set_utc_ymd_time(const frame_data *fd, column_info *cinfo, const int col)
 static void
 set_abs_ydoy_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
-
-  if (fd->flags.has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      g_assert_not_reached();
-    }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%03d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%09d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
-    }
-  } else {
-    buf[0] = '\0';
-  }
+  set_abs_time_style(fd, buf, decimal_point, local, ABS_TIME_YDOY);
 }
 
 static void
@@ -1467,98 +1403,7 @@ col_set_delta_time_dis(const frame_data *fd, column_info *cinfo, const int col)
 static void
 set_abs_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
-
-  if (fd->flags.has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      g_assert_not_reached();
-    }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%01d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%03d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%06d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%02d:%02d:%02d%s%09d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
-    }
-
-  } else {
-    *buf = '\0';
-  }
+  set_abs_time_style(fd, buf, decimal_point, local, ABS_TIME_HMS);
 }
 
 static void
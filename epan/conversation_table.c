@@ -244,6 +244,55 @@ conversation_equal(gconstpointer key1, gconstpointer key2)
     return FALSE;
 }
 
+static guint
+interned_address_hash(gconstpointer v)
+{
+    return add_address_to_hash(0, (const address *)v);
+}
+
+static gboolean
+interned_address_equal(gconstpointer v, gconstpointer w)
+{
+    return addresses_equal((const address *)v, (const address *)w);
+}
+
+static void
+interned_address_free(gpointer data)
+{
+    address *addr = (address *)data;
+
+    free_address(addr);
+    g_free(addr);
+}
+
+/*
+ * Set "to" to refer to a single copy of "from" kept in the table.
+ * Busy hosts take part in many conversations, so this saves allocating
+ * a copy of their address for every conversation and endpoint they
+ * appear in. The copy lives until the table is reset.
+ */
+static void
+intern_address(conv_hash_t *ch, address *to, const address *from)
+{
+    address *interned;
+
+    if (ch->addresses == NULL) {
+        ch->addresses = g_hash_table_new_full(interned_address_hash,
+                                              interned_address_equal,
+                                              interned_address_free,
+                                              NULL);
+    }
+
+    interned = (address *)g_hash_table_lookup(ch->addresses, from);
+    if (interned == NULL) {
+        interned = g_new(address, 1);
+        copy_address(interned, from);
+        g_hash_table_insert(ch->addresses, interned, interned);
+    }
+
+    set_address(to, interned->type, interned->len, interned->data);
+}
+
 void
 reset_conversation_table_data(conv_hash_t *ch)
 {
@@ -251,14 +300,8 @@ reset_conversation_table_data(conv_hash_t *ch)
         return;
     }
 
+    /* The entries' addresses belong to ch->addresses. */
     if (ch->conv_array != NULL) {
-        guint i;
-        for(i = 0; i < ch->conv_array->len; i++){
-            conv_item_t *conv = &g_array_index(ch->conv_array, conv_item_t, i);
-            free_address(&conv->src_address);
-            free_address(&conv->dst_address);
-        }
-
         g_array_free(ch->conv_array, TRUE);
     }
 
@@ -266,8 +309,13 @@ reset_conversation_table_data(conv_hash_t *ch)
         g_hash_table_destroy(ch->hashtable);
     }
 
+    if (ch->addresses != NULL) {
+        g_hash_table_destroy(ch->addresses);
+    }
+
     ch->conv_array=NULL;
     ch->hashtable=NULL;
+    ch->addresses=NULL;
 }
 
 void reset_hostlist_table_data(conv_hash_t *ch)
@@ -276,13 +324,8 @@ void reset_hostlist_table_data(conv_hash_t *ch)
         return;
     }
 
+    /* The entries' addresses belong to ch->addresses. */
     if (ch->conv_array != NULL) {
-        guint i;
-        for(i = 0; i < ch->conv_array->len; i++){
-            hostlist_talker_t *host = &g_array_index(ch->conv_array, hostlist_talker_t, i);
-            free_address(&host->myaddress);
-        }
-
         g_array_free(ch->conv_array, TRUE);
     }
 
@@ -290,8 +333,13 @@ void reset_hostlist_table_data(conv_hash_t *ch)
         g_hash_table_destroy(ch->hashtable);
     }
 
+    if (ch->addresses != NULL) {
+        g_hash_table_destroy(ch->addresses);
+    }
+
     ch->conv_array=NULL;
     ch->hashtable=NULL;
+    ch->addresses=NULL;
 }
 
 char *get_conversation_address(wmem_allocator_t *allocator, address *addr, gboolean resolve_names)
@@ -637,8 +685,8 @@ add_conversation_table_data_with_conv_id(
         conv_key_t *new_key;
         conv_item_t new_conv_item;
 
-        copy_address(&new_conv_item.src_address, addr1);
-        copy_address(&new_conv_item.dst_address, addr2);
+        intern_address(ch, &new_conv_item.src_address, addr1);
+        intern_address(ch, &new_conv_item.dst_address, addr2);
         new_conv_item.dissector_info = ct_info;
         new_conv_item.etype = etype;
         new_conv_item.src_port = port1;
@@ -761,7 +809,7 @@ add_hostlist_table_data(conv_hash_t *ch, const address *addr, guint32 port, gboo
         host_key_t *new_key;
         hostlist_talker_t host;
 
-        copy_address(&host.myaddress, addr);
+        intern_address(ch, &host.myaddress, addr);
         host.dissector_info = host_info;
         host.etype=etype;
         host.port=port;
@@ -54,6 +54,7 @@ typedef struct _conversation_hash_t {
     GHashTable  *hashtable;       /**< conversations hash table */
     GArray      *conv_array;      /**< array of conversation values */
     void        *user_data;       /**< "GUI" specifics (if necessary) */
+    GHashTable  *addresses;       /**< address data shared by all entries */
 } conv_hash_t;
 
 /** Key for hash lookups */
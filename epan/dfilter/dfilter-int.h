@@ -27,6 +27,7 @@ struct epan_dfilter {
 	int		*interesting_fields;
 	int		num_interesting_fields;
 	GPtrArray	*deprecated;
+	struct _dfvm_field_cache *field_cache; /* shared with other filters by dfvm_apply_first() */
 };
 
 typedef struct {
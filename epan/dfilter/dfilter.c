@@ -87,6 +87,8 @@ dfilter_cleanup(void)
 
 	/* Clean up the syntax-tree sub-sub-system */
 	sttype_cleanup();
+
+	dfvm_cleanup();
 }
 
 static dfilter_t*
@@ -409,6 +411,12 @@ dfilter_apply_edt(dfilter_t *df, epan_dissect_t* edt)
 	return dfvm_apply(df, edt->tree);
 }
 
+int
+dfilter_apply_first_edt(dfilter_t **dfs, guint num_dfs, epan_dissect_t* edt)
+{
+	return dfvm_apply_first(dfs, num_dfs, edt->tree);
+}
+
 
 void
 dfilter_prime_proto_tree(const dfilter_t *df, proto_tree *tree)
@@ -60,6 +60,13 @@ WS_DLL_PUBLIC
 gboolean
 dfilter_apply_edt(dfilter_t *df, struct epan_dissect *edt);
 
+/* Apply a list of compiled dfilters to the same tree, in order, and
+ * return the index of the first one that matches or -1 if none do.
+ * Fields tested by several of the filters are only read once. */
+WS_DLL_PUBLIC
+int
+dfilter_apply_first_edt(dfilter_t **dfs, guint num_dfs, struct epan_dissect *edt);
+
 /* Apply compiled dfilter */
 gboolean
 dfilter_apply(dfilter_t *df, proto_tree *tree);
@@ -284,11 +284,56 @@ dfvm_dump(FILE *f, dfilter_t *df)
 	}
 }
 
+/* Field lookups shared by several filters applied to the same tree, so
+ * that each field is read from the tree once rather than once per filter.
+ * Both tables are keyed by the header_field_info of the field. */
+typedef struct _dfvm_field_cache {
+	GHashTable	*loads;		/* GList of fvalues, or NULL_LOAD */
+	GHashTable	*exists;	/* EXISTS_TRUE or EXISTS_FALSE */
+} dfvm_field_cache_t;
+
+/* Marks a field that was looked for and not found. */
+static char null_load;
+#define NULL_LOAD	((gpointer)&null_load)
+
+#define EXISTS_TRUE	GINT_TO_POINTER(1)
+#define EXISTS_FALSE	GINT_TO_POINTER(2)
+
+static gboolean
+check_exists(dfilter_t *df, proto_tree *tree, header_field_info *hfinfo)
+{
+	header_field_info *first = hfinfo;
+	gpointer	cached;
+	gboolean	exists = FALSE;
+
+	if (df->field_cache) {
+		cached = g_hash_table_lookup(df->field_cache->exists, first);
+		if (cached) {
+			return cached == EXISTS_TRUE;
+		}
+	}
+
+	while (hfinfo) {
+		exists = proto_check_for_protocol_or_field(tree, hfinfo->id);
+		if (exists) {
+			break;
+		}
+		hfinfo = hfinfo->same_name_next;
+	}
+
+	if (df->field_cache) {
+		g_hash_table_insert(df->field_cache->exists, first,
+				exists ? EXISTS_TRUE : EXISTS_FALSE);
+	}
+	return exists;
+}
+
 /* Reads a field from the proto_tree and loads the fvalues into a register,
  * if that field has not already been read. */
 static gboolean
 read_tree(dfilter_t *df, proto_tree *tree, header_field_info *hfinfo, int reg)
 {
+	header_field_info *first = hfinfo;
 	GPtrArray	*finfos;
 	field_info	*finfo;
 	int		i, len;
@@ -307,6 +352,20 @@ read_tree(dfilter_t *df, proto_tree *tree, header_field_info *hfinfo, int reg)
 
 	df->attempted_load[reg] = TRUE;
 
+	/* Already loaded by another filter applied to this tree? The list
+	 * belongs to the cache; free_register_overhead() leaves it alone. */
+	if (df->field_cache) {
+		fvalues = (GList *)g_hash_table_lookup(df->field_cache->loads, first);
+		if (fvalues) {
+			if (fvalues == NULL_LOAD) {
+				return FALSE;
+			}
+			df->registers[reg] = fvalues;
+			df->owns_memory[reg] = FALSE;
+			return TRUE;
+		}
+	}
+
 	while (hfinfo) {
 		finfos = proto_get_finfo_ptr_array(tree, hfinfo->id);
 		if ((finfos == NULL) || (g_ptr_array_len(finfos) == 0)) {
@@ -326,6 +385,11 @@ read_tree(dfilter_t *df, proto_tree *tree, header_field_info *hfinfo, int reg)
 		hfinfo = hfinfo->same_name_next;
 	}
 
+	if (df->field_cache) {
+		g_hash_table_insert(df->field_cache->loads, first,
+				found_something ? fvalues : NULL_LOAD);
+	}
+
 	if (!found_something) {
 		return FALSE;
 	}
@@ -416,6 +480,12 @@ free_register_overhead(dfilter_t* df)
 	guint i;
 
 	for (i = 0; i < df->num_registers; i++) {
+		if (df->attempted_load[i] && df->field_cache) {
+			/* Field values loaded through the shared cache. */
+			df->attempted_load[i] = FALSE;
+			df->registers[i] = NULL;
+			continue;
+		}
 		df->attempted_load[i] = FALSE;
 		if (df->registers[i]) {
 			if (df->owns_memory[i]) {
@@ -485,17 +555,7 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 
 		switch (insn->op) {
 			case CHECK_EXISTS:
-				hfinfo = arg1->value.hfinfo;
-				while(hfinfo) {
-					accum = proto_check_for_protocol_or_field(tree,
-							hfinfo->id);
-					if (accum) {
-						break;
-					}
-					else {
-						hfinfo = hfinfo->same_name_next;
-					}
-				}
+				accum = check_exists(df, tree, arg1->value.hfinfo);
 				break;
 
 			case READ_TREE:
@@ -619,6 +679,70 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 	return FALSE; /* to appease the compiler */
 }
 
+static gboolean
+free_cached_load(gpointer key _U_, gpointer value, gpointer user_data _U_)
+{
+	if (value != NULL_LOAD) {
+		g_list_free((GList *)value);
+	}
+	return TRUE;
+}
+
+/* The field cache used by dfvm_apply_first(). It is called for every
+ * colorized packet, so the tables are kept and only emptied. */
+static dfvm_field_cache_t apply_first_cache = { NULL, NULL };
+
+/* Applies each filter in turn to the same tree and returns the index of
+ * the first one that matches, or -1 if none do. Field loads and existence
+ * checks are shared between the filters, so a field tested by many of
+ * them is only looked up in the tree once. */
+int
+dfvm_apply_first(dfilter_t **dfs, guint num_dfs, proto_tree *tree)
+{
+	dfvm_field_cache_t	*cache = &apply_first_cache;
+	guint		i;
+	int		match = -1;
+
+	if (num_dfs == 0) {
+		return -1;
+	}
+	if (num_dfs == 1) {
+		return dfvm_apply(dfs[0], tree) ? 0 : -1;
+	}
+
+	if (cache->loads == NULL) {
+		cache->loads = g_hash_table_new(g_direct_hash, g_direct_equal);
+		cache->exists = g_hash_table_new(g_direct_hash, g_direct_equal);
+	}
+
+	for (i = 0; i < num_dfs; i++) {
+		dfs[i]->field_cache = cache;
+		if (dfvm_apply(dfs[i], tree)) {
+			match = (int)i;
+		}
+		dfs[i]->field_cache = NULL;
+		if (match >= 0) {
+			break;
+		}
+	}
+
+	g_hash_table_foreach_remove(cache->loads, free_cached_load, NULL);
+	g_hash_table_remove_all(cache->exists);
+
+	return match;
+}
+
+void
+dfvm_cleanup(void)
+{
+	if (apply_first_cache.loads != NULL) {
+		g_hash_table_destroy(apply_first_cache.loads);
+		g_hash_table_destroy(apply_first_cache.exists);
+		apply_first_cache.loads = NULL;
+		apply_first_cache.exists = NULL;
+	}
+}
+
 void
 dfvm_init_const(dfilter_t *df)
 {
@@ -88,6 +88,12 @@ dfvm_dump(FILE *f, dfilter_t *df);
 gboolean
 dfvm_apply(dfilter_t *df, proto_tree *tree);
 
+int
+dfvm_apply_first(dfilter_t **dfs, guint num_dfs, proto_tree *tree);
+
+void
+dfvm_cleanup(void);
+
 void
 dfvm_init_const(dfilter_t *df);
 
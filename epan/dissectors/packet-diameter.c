@@ -1214,10 +1214,6 @@ dissect_diameter_common(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, voi
 	nstime_t ns;
 	diam_sub_dis_t *diam_sub_dis_inf = wmem_new0(wmem_packet_scope(), diam_sub_dis_t);
 
-	/* Load header fields if not already done */
-	if (hf_diameter_code == -1)
-		proto_registrar_get_byname("diameter.code");
-
 	col_set_str(pinfo->cinfo, COL_PROTOCOL, "DIAMETER");
 
 	if (have_tap_listener(exported_pdu_tap)){
@@ -2310,7 +2306,7 @@ proto_register_diameter(void)
 	diameter_sctp_handle = register_dissector("diameter", dissect_diameter, proto_diameter);
 
 	/* Delay registration of Diameter fields */
-	proto_register_prefix("diameter", register_diameter_fields);
+	proto_register_fields_deferred(proto_diameter, register_diameter_fields);
 
 	/* Register dissector table(s) to do sub dissection of AVPs (OctetStrings) */
 	diameter_dissector_table = register_dissector_table("diameter.base", "Diameter Base AVP", proto_diameter, FT_UINT32, BASE_DEC);
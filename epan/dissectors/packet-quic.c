@@ -1424,8 +1424,9 @@ quic_decrypt_message(quic_cipher *cipher, tvbuff_t *head, guint header_length, g
     gcry_error_t    err;
     guint8         *header;
     guint8          nonce[TLS13_AEAD_NONCE_LENGTH];
+    const guint8   *ciphertext;
     guint8         *buffer;
-    guint8         *atag[16];
+    const guint8   *atag;
     guint           buffer_length;
     const guchar  **error = &result->error;
 
@@ -1443,8 +1444,10 @@ quic_decrypt_message(quic_cipher *cipher, tvbuff_t *head, guint header_length, g
         *error = "Decryption not possible, ciphertext is too short";
         return;
     }
-    buffer = (guint8 *)tvb_memdup(wmem_file_scope(), head, header_length, buffer_length);
-    tvb_memcpy(head, atag, header_length + buffer_length, 16);
+    /* Read ciphertext and tag in place, the plaintext is written directly
+     * into its final (file-scoped) buffer to avoid an intermediate copy. */
+    ciphertext = tvb_get_ptr(head, header_length, buffer_length + 16);
+    atag = ciphertext + buffer_length;
 
     memcpy(nonce, cipher->pp_iv, TLS13_AEAD_NONCE_LENGTH);
     /* Packet number is left-padded with zeroes and XORed with write_iv */
@@ -1465,14 +1468,17 @@ quic_decrypt_message(quic_cipher *cipher, tvbuff_t *head, guint header_length, g
     }
 
     /* Output ciphertext (C) */
-    err = gcry_cipher_decrypt(cipher->pp_cipher, buffer, buffer_length, NULL, 0);
+    buffer = (guint8 *)wmem_alloc(wmem_file_scope(), buffer_length);
+    err = gcry_cipher_decrypt(cipher->pp_cipher, buffer, buffer_length, ciphertext, buffer_length);
     if (err) {
+        wmem_free(wmem_file_scope(), buffer);
         *error = wmem_strdup_printf(wmem_file_scope(), "Decryption (decrypt) failed: %s", gcry_strerror(err));
         return;
     }
 
     err = gcry_cipher_checktag(cipher->pp_cipher, atag, 16);
     if (err) {
+        wmem_free(wmem_file_scope(), buffer);
         *error = wmem_strdup_printf(wmem_file_scope(), "Decryption (checktag) failed: %s", gcry_strerror(err));
         return;
     }
@@ -1980,10 +1980,6 @@ dissect_radius(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data _
 			val_to_str_ext_const(rh.rh_code, &radius_pkt_type_codes_ext, "Unknown Packet"),
 			rh.rh_ident);
 
-	/* Load header fields if not already done */
-	if (hf_radius_code == -1)
-		proto_registrar_get_byname("radius.code");
-
 	ti = proto_tree_add_item(tree, proto_radius, tvb, 0, rh.rh_pktlength, ENC_NA);
 	radius_tree = proto_item_add_subtree(ti, ett_radius);
 	proto_tree_add_uint(radius_tree, hf_radius_code, tvb, 0, 1, rh.rh_code);
@@ -2842,7 +2838,7 @@ proto_register_radius(void)
 	prefs_register_obsolete_preference(radius_module, "request_ttl");
 
 	radius_tap = register_tap("radius");
-	proto_register_prefix("radius", register_radius_fields);
+	proto_register_fields_deferred(proto_radius, register_radius_fields);
 
 	dict = (radius_dictionary_t *)g_malloc(sizeof(radius_dictionary_t));
 	/*
@@ -4698,7 +4698,9 @@ ssl_common_init(ssl_master_key_map_t *mk_map,
     mk_map->tls13_server_appdata = g_hash_table_new(ssl_hash, ssl_equal);
     mk_map->tls13_early_exporter = g_hash_table_new(ssl_hash, ssl_equal);
     mk_map->tls13_exporter = g_hash_table_new(ssl_hash, ssl_equal);
-    ssl_data_alloc(decrypted_data, 32);
+    /* Size the decryption buffer for the largest ciphertext accepted by the
+     * record layer (2^14 + 2048) so that bulk decryption never reallocates. */
+    ssl_data_alloc(decrypted_data, TLS_MAX_RECORD_LENGTH + 2048 + 32);
     ssl_data_alloc(compressed_data, 32);
 
     /* QUIC keys. */
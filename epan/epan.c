@@ -485,7 +485,6 @@ epan_dissect_reset(epan_dissect_t *edt)
 
 	g_assert(edt);
 
-	g_slist_free(edt->pi.proto_data);
 	g_slist_free(edt->pi.dependent_frames);
 
 	/* Free the data sources list. */
@@ -590,7 +589,6 @@ epan_dissect_cleanup(epan_dissect_t* edt)
 	g_slist_foreach(epan_plugins, epan_plugin_dissect_cleanup, edt);
 #endif
 
-	g_slist_free(edt->pi.proto_data);
 	g_slist_free(edt->pi.dependent_frames);
 
 	/* Free the data sources list. */
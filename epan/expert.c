@@ -525,6 +525,16 @@ expert_set_info_vformat(packet_info *pinfo, proto_item *pi, int group, int sever
 		col_add_str(pinfo->cinfo, COL_EXPERT, val_to_str(severity, expert_severity_vals, "Unknown (%u)"));
 	}
 
+	tap = have_tap_listener(expert_tap);
+
+	/*
+	 * Without an item there is no subtree to add the message to, so
+	 * unless a tap wants it, don't bother formatting it. This is the
+	 * common case when dissecting without a protocol tree.
+	 */
+	if (pi == NULL && !tap)
+		return;
+
 	if (use_vaformat) {
 		ws_vsnprintf(formatted, ITEM_LABEL_LENGTH, format, ap);
 	} else {
@@ -553,8 +563,6 @@ expert_set_info_vformat(packet_info *pinfo, proto_item *pi, int group, int sever
 					      "%s", val_to_str_const(group, expert_group_vals, "Unknown"));
 	PROTO_ITEM_SET_GENERATED(ti);
 
-	tap = have_tap_listener(expert_tap);
-
 	if (!tap)
 		return;
 
@@ -94,6 +94,22 @@ WS_DLL_PUBLIC tap_packet_cb get_eo_packet_func(register_eo_t* eo);
  */
 WS_DLL_PUBLIC export_object_gui_reset_cb get_eo_reset_func(register_eo_t* eo);
 
+/** Note that the Export Object's packet function changes entries after
+ * passing them to add_entry (SMB, for instance, fills in a file as reads
+ * and writes are seen). Callers that save entries as soon as they are
+ * added must wait until the end of the capture for these instead.
+ *
+ * @param proto_id protocol id passed to register_export_object
+ */
+WS_DLL_PUBLIC void set_eo_updates_entries(const int proto_id);
+
+/** Check whether entries of an Export Object change after being added
+ *
+ * @param eo Registered Export Object
+ * @return TRUE if set_eo_updates_entries was called for it
+ */
+WS_DLL_PUBLIC gboolean get_eo_updates_entries(register_eo_t* eo);
+
 /** Get Export Object by its short protocol name
  *
  * @param name short protocol name to fetch.
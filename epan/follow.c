@@ -175,6 +175,70 @@ follow_info_free(follow_info_t* follow_info)
     g_free(follow_info);
 }
 
+follow_index_t*
+follow_index_new(follow_info_t* follow_info)
+{
+    follow_index_t *index = g_new(follow_index_t, 1);
+    GList *cur;
+    guint i;
+
+    index->count = g_list_length(follow_info->payload);
+    index->records = g_new(follow_record_t *, index->count);
+    index->offsets = g_new(guint64, index->count + 1);
+
+    /* The payload list is in reverse order. */
+    i = index->count;
+    for (cur = follow_info->payload; cur; cur = g_list_next(cur)) {
+        index->records[--i] = (follow_record_t *)cur->data;
+    }
+
+    index->offsets[0] = 0;
+    for (i = 0; i < index->count; i++) {
+        index->offsets[i + 1] = index->offsets[i] + index->records[i]->data->len;
+    }
+
+    return index;
+}
+
+guint
+follow_index_find(const follow_index_t* index, guint64 offset)
+{
+    guint low = 0, high = index->count;
+
+    if (offset >= index->offsets[index->count]) {
+        return index->count;
+    }
+
+    /* Find the last record starting at or before offset. */
+    while (high - low > 1) {
+        guint mid = low + (high - low) / 2;
+
+        if (index->offsets[mid] <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    /* Skip any empty records starting at the same offset. */
+    while (low < index->count && index->offsets[low + 1] <= offset) {
+        low++;
+    }
+
+    return low;
+}
+
+void
+follow_index_free(follow_index_t* index)
+{
+    if (!index)
+        return;
+
+    g_free(index->records);
+    g_free(index->offsets);
+    g_free(index);
+}
+
 gboolean
 follow_tvb_tap_listener(void *tapdata, packet_info *pinfo,
                       epan_dissect_t *edt _U_, const void *data)
@@ -95,6 +95,14 @@ typedef struct _follow_info {
     void*           gui_data;
 } follow_info_t;
 
+/** Payload records of a followed stream in stream order, with the stream
+ *  offset at which each one starts, for random access into long streams. */
+typedef struct {
+    guint             count;    /* Number of records */
+    follow_record_t **records;  /* Records in stream order */
+    guint64          *offsets;  /* count + 1 entries; offsets[count] is the stream length */
+} follow_index_t;
+
 struct register_follow;
 typedef struct register_follow register_follow_t;
 
@@ -200,6 +208,30 @@ WS_DLL_PUBLIC void follow_reset_stream(follow_info_t* info);
  */
 WS_DLL_PUBLIC void follow_info_free(follow_info_t* follow_info);
 
+/** Build an index of the payload records collected so far. The index
+ * refers to the records in follow_info, so it must be freed before they
+ * are.
+ *
+ * @param follow_info [in] follower info
+ * @return The index. Free it with follow_index_free.
+ */
+WS_DLL_PUBLIC follow_index_t* follow_index_new(follow_info_t* follow_info);
+
+/** Find the record containing a stream offset
+ *
+ * @param index [in] index from follow_index_new
+ * @param offset [in] offset in the stream, counting both directions
+ * @return Position of the record in index->records, or index->count if the
+ * offset is past the end of the stream.
+ */
+WS_DLL_PUBLIC guint follow_index_find(const follow_index_t* index, guint64 offset);
+
+/** Free an index built by follow_index_new
+ *
+ * @param index [in] index to free
+ */
+WS_DLL_PUBLIC void follow_index_free(follow_index_t* index);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
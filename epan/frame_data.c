@@ -19,6 +19,9 @@
 #include <epan/column-utils.h>
 #include <epan/timestamp.h>
 
+/* Shifted frame_data -> nstime_t offset, see frame_data_set_shift_offset() */
+static GHashTable *shift_offsets = NULL;
+
 #define COMPARE_FRAME_NUM()     ((fdata1->num < fdata2->num) ? -1 : \
                                  (fdata1->num > fdata2->num) ? 1 : \
                                  0)
@@ -201,13 +204,47 @@ frame_data_init(frame_data *fdata, guint32 num, const wtap_rec *rec,
   fdata->flags.has_phdr_comment = (rec->opt_comment != NULL);
   fdata->flags.has_user_comment = 0;
   fdata->flags.need_colorize = 0;
+  fdata->flags.has_shift_offset = 0;
   fdata->color_filter = NULL;
-  fdata->shift_offset.secs = 0;
-  fdata->shift_offset.nsecs = 0;
   fdata->frame_ref_num = 0;
   fdata->prev_dis_num = 0;
 }
 
+void
+frame_data_get_shift_offset(const frame_data *fdata, nstime_t *offset)
+{
+  nstime_t *shift;
+
+  if (fdata->flags.has_shift_offset &&
+      (shift = (nstime_t *)g_hash_table_lookup(shift_offsets, fdata)) != NULL) {
+    *offset = *shift;
+  } else {
+    nstime_set_zero(offset);
+  }
+}
+
+void
+frame_data_set_shift_offset(frame_data *fdata, const nstime_t *offset)
+{
+  nstime_t *shift;
+
+  if (offset == NULL || (offset->secs == 0 && offset->nsecs == 0)) {
+    if (fdata->flags.has_shift_offset) {
+      g_hash_table_remove(shift_offsets, fdata);
+      fdata->flags.has_shift_offset = 0;
+    }
+    return;
+  }
+
+  if (shift_offsets == NULL)
+    shift_offsets = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+
+  shift = g_new(nstime_t, 1);
+  *shift = *offset;
+  g_hash_table_insert(shift_offsets, fdata, shift);
+  fdata->flags.has_shift_offset = 1;
+}
+
 void
 frame_data_set_before_dissect(frame_data *fdata,
                 nstime_t *elapsed_time,
@@ -231,8 +268,7 @@ frame_data_set_before_dissect(frame_data *fdata,
   /* If it's greater than the current elapsed time, set the elapsed time
      to it (we check for "greater than" so as not to be confused by
      time moving backwards). */
-  if ((gint32)elapsed_time->secs < rel_ts.secs
-    || ((gint32)elapsed_time->secs == rel_ts.secs && (gint32)elapsed_time->nsecs < rel_ts.nsecs)) {
+  if (nstime_cmp(elapsed_time, &rel_ts) < 0) {
     *elapsed_time = rel_ts;
   }
 
@@ -264,19 +300,15 @@ frame_data_reset(frame_data *fdata)
   fdata->flags.visited = 0;
   fdata->subnum = 0;
 
-  if (fdata->pfd) {
-    g_slist_free(fdata->pfd);
-    fdata->pfd = NULL;
-  }
+  /* The proto data itself lives in the file scope */
+  fdata->pfd = NULL;
 }
 
 void
 frame_data_destroy(frame_data *fdata)
 {
-  if (fdata->pfd) {
-    g_slist_free(fdata->pfd);
-    fdata->pfd = NULL;
-  }
+  /* The proto data itself lives in the file scope */
+  fdata->pfd = NULL;
 }
 
 /*
@@ -49,9 +49,10 @@ typedef enum {
    it's 1-origin.  In various contexts, 0 as a frame number means "frame
    number unknown". */
 struct _color_filter; /* Forward */
+struct _proto_data_table; /* Forward */
 DIAG_OFF_PEDANTIC
 typedef struct _frame_data {
-  GSList      *pfd;          /**< Per frame proto data */
+  struct _proto_data_table *pfd; /**< Per frame proto data */
   guint32      num;          /**< Frame number */
   guint32      pkt_len;      /**< Packet length */
   guint32      cap_len;      /**< Amount actually captured */
@@ -72,12 +73,12 @@ typedef struct _frame_data {
     unsigned int has_phdr_comment : 1; /** 1 = there's comment for this packet */
     unsigned int has_user_comment : 1; /** 1 = user set (also deleted) comment for this packet */
     unsigned int need_colorize  : 1; /**< 1 = need to (re-)calculate packet color */
+    unsigned int has_shift_offset : 1; /**< 1 = the time stamp has been shifted, see frame_data_get_shift_offset() */
   } flags;
 
   const struct _color_filter *color_filter;  /**< Per-packet matching color_filter_t object */
 
   nstime_t     abs_ts;       /**< Absolute timestamp */
-  nstime_t     shift_offset; /**< How much the abs_tm of the frame is shifted */
   guint32      frame_ref_num; /**< Previous reference frame (0 if this is one) */
   guint32      prev_dis_num; /**< Previous displayed frame (0 if first one) */
 } frame_data;
@@ -107,6 +108,20 @@ WS_DLL_PUBLIC void frame_data_set_before_dissect(frame_data *fdata,
 WS_DLL_PUBLIC void frame_data_set_after_dissect(frame_data *fdata,
                 guint32 *cum_bytes);
 
+/**
+ * Get how much the time stamp of a frame has been shifted; zero if it
+ * hasn't been. Shifts are rare, so they are kept outside of frame_data.
+ */
+WS_DLL_PUBLIC void frame_data_get_shift_offset(const frame_data *fdata,
+                nstime_t *offset);
+
+/**
+ * Set how much the time stamp of a frame has been shifted. This doesn't
+ * change abs_ts. A zero offset forgets the shift.
+ */
+WS_DLL_PUBLIC void frame_data_set_shift_offset(frame_data *fdata,
+                const nstime_t *offset);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -266,6 +266,7 @@ free_frame_data_array(void *array, guint count, guint level, gboolean last)
 
     for (i=0; i < level_count; i++) {
       frame_data_destroy(&real_array[i]);
+      frame_data_set_shift_offset(&real_array[i], NULL);
     }
   }
 
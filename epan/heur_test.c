@@ -0,0 +1,170 @@
+/* heur_test.c
+ * Standalone program to check that, with adaptive heuristics, dissecting a
+ * frame again picks the same heuristic dissectors as the first pass did.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <epan/epan.h>
+#include <epan/frame_data.h>
+#include <epan/packet.h>
+#include <epan/prefs.h>
+#include <epan/wmem/wmem.h>
+
+static int proto_tunnel = -1;
+static int proto_inner = -1;
+
+static heur_dissector_list_t heur_list;
+static heur_dtbl_entry_t    *tunnel_entry;
+
+static guint inner_accepted;
+
+/* "T" followed by a payload, which is handed to the list it came from */
+static gboolean
+dissect_tunnel_heur(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data _U_)
+{
+	heur_dtbl_entry_t *hdtbl_entry;
+	tvbuff_t          *next_tvb;
+
+	if (tvb_reported_length(tvb) < 2 || tvb_get_guint8(tvb, 0) != 'T')
+		return FALSE;
+
+	next_tvb = tvb_new_subset_remaining(tvb, 1);
+	dissector_try_heuristic(heur_list, next_tvb, pinfo, tree, &hdtbl_entry, NULL);
+	return TRUE;
+}
+
+/* "I" */
+static gboolean
+dissect_inner_heur(tvbuff_t *tvb, packet_info *pinfo _U_, proto_tree *tree _U_, void *data _U_)
+{
+	if (tvb_get_guint8(tvb, 0) != 'I')
+		return FALSE;
+
+	inner_accepted++;
+	return TRUE;
+}
+
+static heur_dtbl_entry_t *
+dissect_payload(frame_data *fd, const char *payload)
+{
+	packet_info        pinfo;
+	tvbuff_t          *tvb;
+	heur_dtbl_entry_t *hdtbl_entry;
+	gint               len = (gint)strlen(payload);
+
+	memset(&pinfo, 0, sizeof pinfo);
+	pinfo.fd = fd;
+	pinfo.num = fd->num;
+	pinfo.pool = wmem_allocator_new(WMEM_ALLOCATOR_STRICT);
+	pinfo.layers = wmem_list_new(pinfo.pool);
+
+	tvb = tvb_new_real_data((const guint8 *)payload, len, len);
+	dissector_try_heuristic(heur_list, tvb, &pinfo, NULL, &hdtbl_entry, NULL);
+	tvb_free(tvb);
+
+	wmem_destroy_allocator(pinfo.pool);
+	return hdtbl_entry;
+}
+
+/*
+ * Dissect the frame twice, the second time as a revisit, and check that
+ * both passes end up with the tunnel and, if wanted, the inner dissector.
+ */
+static void
+check_revisit(guint32 num, const char *payload, guint inner)
+{
+	frame_data fd;
+
+	memset(&fd, 0, sizeof fd);
+	fd.num = num;
+
+	inner_accepted = 0;
+	g_assert(dissect_payload(&fd, payload) == tunnel_entry);
+	g_assert_cmpuint(inner_accepted, ==, inner);
+
+	fd.flags.visited = 1;
+	inner_accepted = 0;
+	g_assert(dissect_payload(&fd, payload) == tunnel_entry);
+	g_assert_cmpuint(inner_accepted, ==, inner);
+}
+
+/* The nested call of the list comes after the outer one */
+static void
+test_nested_no_match(void)
+{
+	check_revisit(1, "TX", 0);
+}
+
+static void
+test_nested_match(void)
+{
+	check_revisit(2, "TI", 1);
+}
+
+static void
+test_nested_twice(void)
+{
+	check_revisit(3, "TTI", 1);
+	check_revisit(4, "TTX", 0);
+}
+
+int
+main(int argc, char **argv)
+{
+	static const struct packet_provider_funcs funcs = { NULL, NULL, NULL, NULL };
+	epan_t *session;
+	int     ret;
+
+	g_test_init(&argc, &argv, NULL);
+
+	if (!epan_init(NULL, NULL, FALSE))
+		return 1;
+
+	proto_tunnel = proto_register_protocol("Heuristic Test Tunnel", "HEURTUNNEL", "heurtunnel");
+	proto_inner = proto_register_protocol("Heuristic Test Inner", "HEURINNER", "heurinner");
+	heur_list = register_heur_dissector_list("heurtest", proto_tunnel);
+	heur_dissector_add("heurtest", dissect_tunnel_heur, "Tunnel", "heurtunnel_test",
+			   proto_tunnel, HEURISTIC_ENABLE);
+	heur_dissector_add("heurtest", dissect_inner_heur, "Inner", "heurinner_test",
+			   proto_inner, HEURISTIC_ENABLE);
+	tunnel_entry = find_heur_dissector_by_unique_short_name("heurtunnel_test");
+	g_assert(tunnel_entry != NULL);
+
+	prefs.adaptive_heuristics = TRUE;
+	session = epan_new(NULL, &funcs);
+
+	g_test_add_func("/heur/nested_no_match", test_nested_no_match);
+	g_test_add_func("/heur/nested_match", test_nested_match);
+	g_test_add_func("/heur/nested_twice", test_nested_twice);
+
+	ret = g_test_run();
+
+	epan_free(session);
+	epan_cleanup();
+
+	return ret;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -32,16 +32,19 @@
 #include "wmem/wmem.h"
 
 #include <epan/exceptions.h>
+#include <epan/conversation.h>
 #include <epan/reassemble.h>
 #include <epan/stream.h>
 #include <epan/expert.h>
 #include <epan/prefs.h>
+#include <epan/proto_data.h>
 #include <epan/range.h>
 
 #include <wsutil/str_util.h>
 #include <wsutil/ws_printf.h> /* ws_debug_printf */
 
 static gint proto_malformed = -1;
+static gint proto_frame = -1;
 static dissector_handle_t frame_handle = NULL;
 static dissector_handle_t file_handle = NULL;
 static dissector_handle_t data_handle = NULL;
@@ -157,10 +160,123 @@ destroy_depend_dissector_list(void *data)
 struct heur_dissector_list {
 	protocol_t	*protocol;
 	GSList		*dissectors;
+	GPtrArray	*ranked;	/* dissectors by hits, with adaptive_heuristics */
+	guint		calls_since_ranked;
 };
 
 static GHashTable *heur_dissector_lists = NULL;
 
+/*
+ * With adaptive_heuristics, the heuristic that last accepted a packet of a
+ * conversation, per list; cleared with the conversations.
+ */
+typedef struct {
+	guint32			conv_index;
+	heur_dissector_list_t	list;
+} heur_memo_key_t;
+
+static GHashTable *heur_memo = NULL;
+
+/* How often a list in use is re-sorted by hits */
+#define HEUR_RERANK_INTERVAL	1024
+
+/*
+ * With adaptive_heuristics, the heuristic that accepted each call of a list
+ * on the first pass, in the order of the calls, kept as per-frame data of
+ * the frame protocol. Dissecting the frame again replays them, so that it
+ * gives the same result however the lists have been ranked since. A call's
+ * slot is taken before any dissector is tried, so that calls made from
+ * within that dissector come after it, as they do when replaying, and holds
+ * the dissector being tried, so that one which throws is tried again.
+ */
+typedef struct {
+	heur_dissector_list_t	list;
+	heur_dtbl_entry_t	*entry;		/* NULL if none did */
+} heur_choice_t;
+
+#define HEUR_CHOICES_KEY	0
+
+static guint
+heur_memo_hash(gconstpointer k)
+{
+	const heur_memo_key_t *key = (const heur_memo_key_t *)k;
+
+	return g_direct_hash(key->list) ^ key->conv_index;
+}
+
+static gboolean
+heur_memo_equal(gconstpointer k1, gconstpointer k2)
+{
+	const heur_memo_key_t *key1 = (const heur_memo_key_t *)k1;
+	const heur_memo_key_t *key2 = (const heur_memo_key_t *)k2;
+
+	return key1->conv_index == key2->conv_index && key1->list == key2->list;
+}
+
+static void
+heur_memo_free_key(gpointer k)
+{
+	g_slice_free(heur_memo_key_t, k);
+}
+
+/* Forget the ranking of a list whose dissectors changed */
+static void
+heur_list_unrank(heur_dissector_list_t list)
+{
+	if (list->ranked) {
+		g_ptr_array_free(list->ranked, TRUE);
+		list->ranked = NULL;
+	}
+	list->calls_since_ranked = 0;
+}
+
+static gint
+heur_entry_compare_hits(gconstpointer a, gconstpointer b)
+{
+	const heur_dtbl_entry_t *entry_a = *(const heur_dtbl_entry_t * const *)a;
+	const heur_dtbl_entry_t *entry_b = *(const heur_dtbl_entry_t * const *)b;
+
+	if (entry_a->hits > entry_b->hits)
+		return -1;
+	if (entry_a->hits < entry_b->hits)
+		return 1;
+	return 0;
+}
+
+/*
+ * Sort a list's dissectors by hits, most first. The sort is stable, so
+ * dissectors that never accepted anything keep their registration order.
+ */
+static void
+heur_list_rank(heur_dissector_list_t list)
+{
+	GSList *entry;
+
+	if (!list->ranked) {
+		list->ranked = g_ptr_array_new();
+		for (entry = list->dissectors; entry != NULL; entry = g_slist_next(entry))
+			g_ptr_array_add(list->ranked, entry->data);
+	}
+	g_ptr_array_sort(list->ranked, heur_entry_compare_hits);
+	list->calls_since_ranked = 0;
+}
+
+/* Forget what a list's dissectors have accepted so far */
+static void
+heur_list_reset_counts(gpointer key _U_, gpointer value, gpointer user_data _U_)
+{
+	heur_dissector_list_t list = (heur_dissector_list_t)value;
+	heur_dtbl_entry_t *hdtbl_entry;
+	GSList *entry;
+
+	for (entry = list->dissectors; entry != NULL; entry = g_slist_next(entry)) {
+		hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
+		hdtbl_entry->tries = 0;
+		hdtbl_entry->hits = 0;
+	}
+	heur_list_unrank(list);
+}
+
 /* Name hashtables for fast detection of duplicate names */
 static GHashTable* heuristic_short_names  = NULL;
 
@@ -180,6 +296,8 @@ destroy_heuristic_dissector_list(void *data)
 	GSList **list = &(dissector_list->dissectors);
 
 	g_slist_free_full(*list, destroy_heuristic_dissector_entry);
+	if (dissector_list->ranked)
+		g_ptr_array_free(dissector_list->ranked, TRUE);
 	g_slice_free(struct heur_dissector_list, dissector_list);
 }
 
@@ -212,6 +330,9 @@ packet_init(void)
 			NULL, destroy_heuristic_dissector_list);
 
 	heuristic_short_names  = g_hash_table_new(g_str_hash, g_str_equal);
+
+	heur_memo = g_hash_table_new_full(heur_memo_hash, heur_memo_equal,
+			heur_memo_free_key, NULL);
 }
 
 void
@@ -228,6 +349,9 @@ packet_cache_proto_handles(void)
 
 	proto_malformed = proto_get_id_by_filter_name("_ws.malformed");
 	g_assert(proto_malformed != -1);
+
+	proto_frame = proto_get_id_by_filter_name("frame");
+	g_assert(proto_frame != -1);
 }
 
 /* List of routines that are called before we make a pass through a capture file
@@ -237,6 +361,11 @@ static GSList *init_routines = NULL;
 static GSList *cleanup_routines = NULL;
 static GSList *shutdown_routines = NULL;
 
+/* Dissector profiling, see dissector_profile_enable() */
+static gboolean    profiling_enabled = FALSE;
+static GHashTable *profiles = NULL;        /* proto_id -> dissector_profile_t */
+static GArray     *profile_stack = NULL;   /* of profile_frame_t */
+
 typedef void (*void_func_t)(void);
 
 /* Initialize all data structures used for dissection. */
@@ -259,8 +388,16 @@ packet_cleanup(void)
 	g_hash_table_destroy(depend_dissector_lists);
 	g_hash_table_destroy(heur_dissector_lists);
 	g_hash_table_destroy(heuristic_short_names);
+	g_hash_table_destroy(heur_memo);
 	g_slist_foreach(shutdown_routines, &call_routine, NULL);
 	g_slist_free(shutdown_routines);
+	if (profiles) {
+		g_hash_table_destroy(profiles);
+		g_array_free(profile_stack, TRUE);
+		profiles = NULL;
+		profile_stack = NULL;
+		profiling_enabled = FALSE;
+	}
 	if (postdissectors) {
 		for (guint i = 0; i < postdissectors->len; i++) {
 			if (POSTDISSECTORS(i).wanted_hfids) {
@@ -346,6 +483,11 @@ cleanup_dissection(void)
 	/* Cleanup the expert infos */
 	expert_packet_cleanup();
 
+	/* The conversations are about to go, and what the heuristics did
+	   with them doesn't say anything about the next capture */
+	g_hash_table_remove_all(heur_memo);
+	g_hash_table_foreach(heur_dissector_lists, heur_list_reset_counts, NULL);
+
 	wmem_leave_file_scope();
 
 	/*
@@ -700,6 +842,7 @@ call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 	if ((handle->protocol != NULL) && (!proto_is_pino(handle->protocol))) {
 		pinfo->current_proto =
 			proto_get_protocol_short_name(handle->protocol);
+		proto_initialize_deferred_fields(handle->protocol);
 	}
 
 	if (handle->dissector_type == DISSECTOR_TYPE_SIMPLE) {
@@ -716,6 +859,106 @@ call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 	return len;
 }
 
+/*
+ * Dissector profiling.
+ * While enabled, every call through a handle or to a heuristic dissector
+ * is timed and charged to the dissector's protocol, both with and without
+ * the time spent in the subdissectors it called.  A stack of the calls in
+ * progress tracks the latter; a call abandoned by an exception is popped,
+ * and charged, when its caller returns.
+ */
+typedef struct {
+	dissector_profile_t *profile;
+	gint64               start;
+	gint64               child_us;
+	guint                start_items;
+	guint                child_items;
+} profile_frame_t;
+
+void
+dissector_profile_enable(gboolean enable)
+{
+	if (enable && !profiles) {
+		profiles = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+		profile_stack = g_array_new(FALSE, FALSE, sizeof(profile_frame_t));
+	}
+	profiling_enabled = enable;
+}
+
+void
+dissector_profile_reset(void)
+{
+	if (profiles) {
+		g_hash_table_remove_all(profiles);
+		g_array_set_size(profile_stack, 0);
+	}
+}
+
+void
+dissector_profile_foreach(dissector_profile_func func, gpointer user_data)
+{
+	GHashTableIter iter;
+	gpointer       value;
+
+	if (!profiles)
+		return;
+
+	g_hash_table_iter_init(&iter, profiles);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		func((const dissector_profile_t *)value, user_data);
+	}
+}
+
+static guint
+profile_enter(protocol_t *protocol, proto_tree *tree)
+{
+	int                  proto_id = proto_get_id(protocol);
+	dissector_profile_t *profile;
+	profile_frame_t      frame;
+	guint                depth = profile_stack->len;
+
+	profile = (dissector_profile_t *)g_hash_table_lookup(profiles, GINT_TO_POINTER(proto_id));
+	if (!profile) {
+		profile = g_new0(dissector_profile_t, 1);
+		profile->proto_id = proto_id;
+		g_hash_table_insert(profiles, GINT_TO_POINTER(proto_id), profile);
+	}
+	profile->calls++;
+
+	frame.profile = profile;
+	frame.child_us = 0;
+	frame.child_items = 0;
+	frame.start_items = tree ? tree->tree_data->count : 0;
+	frame.start = g_get_monotonic_time();
+	g_array_append_val(profile_stack, frame);
+
+	return depth;
+}
+
+static void
+profile_leave(guint depth, proto_tree *tree)
+{
+	gint64 now = g_get_monotonic_time();
+	guint  items = tree ? tree->tree_data->count : 0;
+
+	while (profile_stack->len > depth) {
+		profile_frame_t *frame = &g_array_index(profile_stack, profile_frame_t, profile_stack->len - 1);
+		gint64 elapsed = now - frame->start;
+		guint  added = items >= frame->start_items ? items - frame->start_items : 0;
+
+		frame->profile->total_us += elapsed;
+		frame->profile->self_us += elapsed - frame->child_us;
+		frame->profile->tree_items += added - MIN(added, frame->child_items);
+
+		g_array_set_size(profile_stack, profile_stack->len - 1);
+		if (profile_stack->len > 0) {
+			frame = &g_array_index(profile_stack, profile_frame_t, profile_stack->len - 1);
+			frame->child_us += elapsed;
+			frame->child_items += added;
+		}
+	}
+}
+
 /*
  * Call a dissector through a handle.
  * If the protocol for that handle isn't enabled, return 0 without
@@ -739,6 +982,7 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 	int          len;
 	guint        saved_layers_len = 0;
 	int          saved_tree_count = tree ? tree->tree_data->count : 0;
+	guint        profile_depth = 0;
 
 	if (handle->protocol != NULL &&
 	    !proto_is_protocol_enabled(handle->protocol)) {
@@ -782,6 +1026,9 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 		}
 	}
 
+	if (G_UNLIKELY(profiling_enabled) && handle->protocol != NULL)
+		profile_depth = profile_enter(handle->protocol, tree);
+
 	if (pinfo->flags.in_error_pkt) {
 		len = call_dissector_work_error(handle, tvb, pinfo, tree, data);
 	} else {
@@ -790,6 +1037,9 @@ call_dissector_work(dissector_handle_t handle, tvbuff_t *tvb, packet_info *pinfo
 		 */
 		len = call_dissector_through_handle(handle, tvb, pinfo, tree, data);
 	}
+
+	if (G_UNLIKELY(profiling_enabled) && handle->protocol != NULL)
+		profile_leave(profile_depth, tree);
 	if (handle->protocol != NULL && !proto_is_pino(handle->protocol) && add_proto_name &&
 		(len == 0 || (tree && saved_tree_count == tree->tree_data->count))) {
 		/*
@@ -2627,12 +2877,15 @@ heur_dissector_add(const char *name, heur_dissector_t dissector, const char *dis
 	hdtbl_entry->short_name = g_strdup(short_name);
 	hdtbl_entry->list_name = g_strdup(name);
 	hdtbl_entry->enabled   = (enable == HEURISTIC_ENABLE);
+	hdtbl_entry->tries     = 0;
+	hdtbl_entry->hits      = 0;
 
 	/* do the table insertion */
 	g_hash_table_insert(heuristic_short_names, (gpointer)hdtbl_entry->short_name, hdtbl_entry);
 
 	sub_dissectors->dissectors = g_slist_prepend(sub_dissectors->dissectors,
 	    (gpointer)hdtbl_entry);
+	heur_list_unrank(sub_dissectors);
 
 	/* XXX - could be optimized to pass hdtbl_entry directly */
 	proto_add_heuristic_dissector(hdtbl_entry->protocol, hdtbl_entry->short_name);
@@ -2678,7 +2931,234 @@ heur_dissector_delete(const char *name, heur_dissector_t dissector, const int pr
 		g_slice_free(heur_dtbl_entry_t, found_entry->data);
 		sub_dissectors->dissectors = g_slist_delete_link(sub_dissectors->dissectors,
 		    found_entry);
+		heur_list_unrank(sub_dissectors);
+		g_hash_table_remove_all(heur_memo);
+	}
+}
+
+/*
+ * Try one heuristic dissector. Returns TRUE if it accepted the packet.
+ */
+static gboolean
+try_heuristic_entry(heur_dtbl_entry_t *hdtbl_entry, tvbuff_t *tvb,
+		    packet_info *pinfo, proto_tree *tree, void *data,
+		    guint16 saved_can_desegment, guint saved_layers_len)
+{
+	int   proto_id;
+	int   len;
+	int   saved_tree_count = tree ? tree->tree_data->count : 0;
+	guint profile_depth = 0;
+
+	/* XXX - why set this now and above? */
+	pinfo->can_desegment = saved_can_desegment-(saved_can_desegment>0);
+
+	if (hdtbl_entry->protocol != NULL &&
+		(!proto_is_protocol_enabled(hdtbl_entry->protocol)||(hdtbl_entry->enabled==FALSE))) {
+		/*
+		 * No - don't try this dissector.
+		 */
+		return FALSE;
+	}
+
+	if (hdtbl_entry->protocol != NULL) {
+		proto_id = proto_get_id(hdtbl_entry->protocol);
+		/* do NOT change this behavior - wslua uses the protocol short name set here in order
+		   to determine which Lua-based heurisitc dissector to call */
+		pinfo->current_proto =
+			proto_get_protocol_short_name(hdtbl_entry->protocol);
+
+		/*
+		 * Add the protocol name to the layers; we'll remove it
+		 * if the dissector fails.
+		 */
+		pinfo->curr_layer_num++;
+		wmem_list_append(pinfo->layers, GINT_TO_POINTER(proto_id));
+		proto_initialize_deferred_fields(hdtbl_entry->protocol);
+	}
+
+	pinfo->heur_list_name = hdtbl_entry->list_name;
+
+	if (G_UNLIKELY(profiling_enabled) && hdtbl_entry->protocol != NULL)
+		profile_depth = profile_enter(hdtbl_entry->protocol, tree);
+
+	hdtbl_entry->tries++;
+	len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+
+	if (G_UNLIKELY(profiling_enabled) && hdtbl_entry->protocol != NULL)
+		profile_leave(profile_depth, tree);
+	if (hdtbl_entry->protocol != NULL &&
+		(len == 0 || (tree && saved_tree_count == tree->tree_data->count))) {
+		/*
+		 * We added a protocol layer above. The dissector
+		 * didn't accept the packet or it didn't add any
+		 * items to the tree so remove it from the list.
+		 */
+		while (wmem_list_count(pinfo->layers) > saved_layers_len) {
+			pinfo->curr_layer_num--;
+			wmem_list_remove_frame(pinfo->layers, wmem_list_tail(pinfo->layers));
+		}
+	}
+	if (len) {
+		hdtbl_entry->hits++;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+ * Take the next slot for a call of the list, with nothing chosen yet.
+ * Returns its index, to be passed to heur_choice_record().
+ */
+static guint
+heur_choice_reserve(packet_info *pinfo, heur_dissector_list_t list)
+{
+	wmem_array_t  *choices;
+	heur_choice_t  choice;
+
+	choices = (wmem_array_t *)p_get_proto_data(wmem_file_scope(), pinfo,
+						   proto_frame, HEUR_CHOICES_KEY);
+	if (!choices) {
+		choices = wmem_array_new(wmem_file_scope(), sizeof(heur_choice_t));
+		p_add_proto_data(wmem_file_scope(), pinfo, proto_frame,
+				 HEUR_CHOICES_KEY, choices);
 	}
+	choice.list = list;
+	choice.entry = NULL;
+	wmem_array_append_one(choices, choice);
+
+	return wmem_array_get_count(choices) - 1;
+}
+
+static void
+heur_choice_record(packet_info *pinfo, guint slot,
+		   heur_dtbl_entry_t *hdtbl_entry)
+{
+	wmem_array_t  *choices;
+	heur_choice_t *choice;
+
+	/* Nested calls may have grown the array, so look it up again */
+	choices = (wmem_array_t *)p_get_proto_data(wmem_file_scope(), pinfo,
+						   proto_frame, HEUR_CHOICES_KEY);
+	choice = (heur_choice_t *)wmem_array_index(choices, slot);
+	choice->entry = hdtbl_entry;
+}
+
+/*
+ * Look up what the first pass chose for this call of the list. Returns
+ * FALSE if it didn't record anything, e.g. because the preference was off.
+ */
+static gboolean
+heur_choice_replay(packet_info *pinfo, heur_dissector_list_t list,
+		   heur_dtbl_entry_t **hdtbl_entry)
+{
+	wmem_array_t  *choices;
+	heur_choice_t *choice;
+	guint         *next;
+	guint          i;
+
+	choices = (wmem_array_t *)p_get_proto_data(wmem_file_scope(), pinfo,
+						   proto_frame, HEUR_CHOICES_KEY);
+	if (!choices)
+		return FALSE;
+
+	/* Where the previous call in this dissection left off */
+	next = (guint *)p_get_proto_data(pinfo->pool, pinfo, proto_frame,
+					 HEUR_CHOICES_KEY);
+	if (!next) {
+		next = wmem_new0(pinfo->pool, guint);
+		p_add_proto_data(pinfo->pool, pinfo, proto_frame,
+				 HEUR_CHOICES_KEY, next);
+	}
+
+	for (i = *next; i < wmem_array_get_count(choices); i++) {
+		choice = (heur_choice_t *)wmem_array_index(choices, i);
+		if (choice->list == list) {
+			*next = i + 1;
+			/* Unless it has been removed since */
+			if (choice->entry != NULL &&
+			    g_slist_find(list->dissectors, choice->entry) == NULL)
+				return FALSE;
+			*hdtbl_entry = choice->entry;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * With adaptive_heuristics: try the dissector that last accepted a packet
+ * of this conversation first, then the others in order of hits. A frame
+ * that is dissected again gets the dissector the first pass chose.
+ */
+static heur_dtbl_entry_t *
+try_heuristics_adaptive(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
+			packet_info *pinfo, proto_tree *tree, void *data,
+			guint16 saved_can_desegment, guint saved_layers_len)
+{
+	conversation_t    *conv;
+	heur_memo_key_t    key;
+	heur_memo_key_t   *new_key;
+	heur_dtbl_entry_t *memo = NULL;
+	heur_dtbl_entry_t *hdtbl_entry;
+	heur_dtbl_entry_t *found = NULL;
+	guint              slot = 0;
+	guint              i;
+
+	if (!pinfo->fd->flags.visited)
+		slot = heur_choice_reserve(pinfo, sub_dissectors);
+	else if (heur_choice_replay(pinfo, sub_dissectors, &hdtbl_entry)) {
+		if (hdtbl_entry == NULL ||
+		    try_heuristic_entry(hdtbl_entry, tvb, pinfo, tree, data,
+					saved_can_desegment, saved_layers_len))
+			return hdtbl_entry;
+		/* It doesn't want the packet any more; look for another one */
+	}
+
+	conv = find_conversation_pinfo(pinfo, 0);
+	if (conv) {
+		key.conv_index = conv->conv_index;
+		key.list = sub_dissectors;
+		memo = (heur_dtbl_entry_t *)g_hash_table_lookup(heur_memo, &key);
+		if (memo) {
+			if (!pinfo->fd->flags.visited)
+				heur_choice_record(pinfo, slot, memo);
+			if (try_heuristic_entry(memo, tvb, pinfo, tree, data,
+						saved_can_desegment, saved_layers_len))
+				found = memo;
+			else
+				g_hash_table_remove(heur_memo, &key);
+		}
+	}
+
+	if (!found) {
+		if (!sub_dissectors->ranked ||
+		    sub_dissectors->calls_since_ranked >= HEUR_RERANK_INTERVAL)
+			heur_list_rank(sub_dissectors);
+		sub_dissectors->calls_since_ranked++;
+
+		for (i = 0; i < sub_dissectors->ranked->len; i++) {
+			hdtbl_entry = (heur_dtbl_entry_t *)g_ptr_array_index(sub_dissectors->ranked, i);
+			if (hdtbl_entry == memo)
+				continue;	/* already tried */
+
+			if (!pinfo->fd->flags.visited)
+				heur_choice_record(pinfo, slot, hdtbl_entry);
+			if (try_heuristic_entry(hdtbl_entry, tvb, pinfo, tree, data,
+						saved_can_desegment, saved_layers_len)) {
+				if (conv) {
+					new_key = g_slice_new(heur_memo_key_t);
+					*new_key = key;
+					g_hash_table_insert(heur_memo, new_key, hdtbl_entry);
+				}
+				found = hdtbl_entry;
+				break;
+			}
+		}
+	}
+
+	if (!pinfo->fd->flags.visited)
+		heur_choice_record(pinfo, slot, found);
+	return found;
 }
 
 gboolean
@@ -2692,9 +3172,6 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 	guint16            saved_can_desegment;
 	guint              saved_layers_len = 0;
 	heur_dtbl_entry_t *hdtbl_entry;
-	int                proto_id;
-	int                len;
-	int                saved_tree_count = tree ? tree->tree_data->count : 0;
 
 	/* can_desegment is set to 2 by anyone which offers this api/service.
 	   then everytime a subdissector is called it is decremented by one.
@@ -2716,55 +3193,21 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 	saved_layers_len = wmem_list_count(pinfo->layers);
 	*heur_dtbl_entry = NULL;
 
-	for (entry = sub_dissectors->dissectors; entry != NULL;
-	    entry = g_slist_next(entry)) {
-		/* XXX - why set this now and above? */
-		pinfo->can_desegment = saved_can_desegment-(saved_can_desegment>0);
-		hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
-
-		if (hdtbl_entry->protocol != NULL &&
-			(!proto_is_protocol_enabled(hdtbl_entry->protocol)||(hdtbl_entry->enabled==FALSE))) {
-			/*
-			 * No - don't try this dissector.
-			 */
-			continue;
-		}
-
-		if (hdtbl_entry->protocol != NULL) {
-			proto_id = proto_get_id(hdtbl_entry->protocol);
-			/* do NOT change this behavior - wslua uses the protocol short name set here in order
-			   to determine which Lua-based heurisitc dissector to call */
-			pinfo->current_proto =
-				proto_get_protocol_short_name(hdtbl_entry->protocol);
-
-			/*
-			 * Add the protocol name to the layers; we'll remove it
-			 * if the dissector fails.
-			 */
-			pinfo->curr_layer_num++;
-			wmem_list_append(pinfo->layers, GINT_TO_POINTER(proto_id));
-		}
-
-		pinfo->heur_list_name = hdtbl_entry->list_name;
-
-		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
-		if (hdtbl_entry->protocol != NULL &&
-			(len == 0 || (tree && saved_tree_count == tree->tree_data->count))) {
-			/*
-			 * We added a protocol layer above. The dissector
-			 * didn't accept the packet or it didn't add any
-			 * items to the tree so remove it from the list.
-			 */
-			while (wmem_list_count(pinfo->layers) > saved_layers_len) {
-				pinfo->curr_layer_num--;
-				wmem_list_remove_frame(pinfo->layers, wmem_list_tail(pinfo->layers));
+	if (prefs.adaptive_heuristics) {
+		*heur_dtbl_entry = try_heuristics_adaptive(sub_dissectors, tvb,
+				pinfo, tree, data, saved_can_desegment, saved_layers_len);
+		status = (*heur_dtbl_entry != NULL);
+	} else {
+		for (entry = sub_dissectors->dissectors; entry != NULL;
+		    entry = g_slist_next(entry)) {
+			hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
+			if (try_heuristic_entry(hdtbl_entry, tvb, pinfo, tree, data,
+						saved_can_desegment, saved_layers_len)) {
+				*heur_dtbl_entry = hdtbl_entry;
+				status = TRUE;
+				break;
 			}
 		}
-		if (len) {
-			*heur_dtbl_entry = hdtbl_entry;
-			status = TRUE;
-			break;
-		}
 	}
 
 	pinfo->current_proto = saved_curr_proto;
@@ -2921,6 +3364,8 @@ register_heur_dissector_list(const char *name, const int proto)
 	sub_dissectors = g_slice_new(struct heur_dissector_list);
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->dissectors = NULL;	/* initially empty */
+	sub_dissectors->ranked = NULL;
+	sub_dissectors->calls_since_ranked = 0;
 	g_hash_table_insert(heur_dissector_lists, (gpointer)name,
 			    (gpointer) sub_dissectors);
 	return sub_dissectors;
@@ -3221,6 +3666,7 @@ void call_heur_dissector_direct(heur_dtbl_entry_t *heur_dtbl_entry, tvbuff_t *tv
 		pinfo->current_proto = proto_get_protocol_short_name(heur_dtbl_entry->protocol);
 		pinfo->curr_layer_num++;
 		wmem_list_append(pinfo->layers, GINT_TO_POINTER(proto_get_id(heur_dtbl_entry->protocol)));
+		proto_initialize_deferred_fields(heur_dtbl_entry->protocol);
 	}
 
 	pinfo->heur_list_name = heur_dtbl_entry->list_name;
@@ -433,6 +433,8 @@ typedef struct heur_dtbl_entry {
 	const gchar *display_name;     /* the string used to present heuristic to user */
 	gchar *short_name;     /* string used for "internal" use to uniquely identify heuristic */
 	gboolean enabled;
+	guint64 tries;         /* number of times this heuristic was tried */
+	guint64 hits;          /* number of times it accepted the packet */
 } heur_dtbl_entry_t;
 
 /** A protocol uses this function to register a heuristic sub-dissector list.
@@ -836,6 +838,33 @@ WS_DLL_PUBLIC gboolean postdissectors_want_hfids(void);
 WS_DLL_PUBLIC void
 prime_epan_dissect_with_postdissector_wanted_hfids(epan_dissect_t *edt);
 
+/** Dissection cost of one protocol, collected while profiling is enabled. */
+typedef struct {
+	int      proto_id;    /**< protocol whose dissectors were called */
+	guint64  calls;       /**< calls to its dissectors */
+	gint64   total_us;    /**< microseconds spent in them, with subdissectors */
+	gint64   self_us;     /**< microseconds spent in them, without subdissectors */
+	guint64  tree_items;  /**< protocol tree items they added themselves */
+} dissector_profile_t;
+
+typedef void (*dissector_profile_func)(const dissector_profile_t *profile, gpointer user_data);
+
+/*
+ * Start or stop charging the time spent in dissectors called through
+ * handles or heuristic lists to their protocols.
+ */
+WS_DLL_PUBLIC void dissector_profile_enable(gboolean enable);
+
+/*
+ * Forget everything collected so far.
+ */
+WS_DLL_PUBLIC void dissector_profile_reset(void);
+
+/*
+ * Call func for each protocol with collected data, in no particular order.
+ */
+WS_DLL_PUBLIC void dissector_profile_foreach(dissector_profile_func func, gpointer user_data);
+
 /** @} */
 
 #ifdef __cplusplus
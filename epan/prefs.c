@@ -3638,6 +3638,14 @@ prefs_register_modules(void)
                                    "Currently only ICMP and ICMPv6 use this preference to add VLAN ID to conversation tracking",
                                    &prefs.strict_conversation_tracking_heuristics);
 
+    prefs_register_bool_preference(protocols_module, "adaptive_heuristics",
+                                   "Try the most successful heuristic dissectors first",
+                                   "Try heuristic dissectors in order of how often they have accepted packets rather than "
+                                   "in registration order, and try the one that last accepted a packet of a conversation "
+                                   "first for the rest of that conversation. This is faster on traffic with many "
+                                   "heuristic candidates, but may change which dissector claims an ambiguous packet.",
+                                   &prefs.adaptive_heuristics);
+
     /* Obsolete preferences
      * These "modules" were reorganized/renamed to correspond to their GUI
      * configuration screen within the preferences dialog
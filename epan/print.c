@@ -1069,6 +1069,12 @@ proto_node_group_children_by_unique(proto_node *node) {
     return g_slist_reverse(unique_nodes_list);
 }
 
+/*
+ * Up to this many distinct keys, the group of a child is found by comparing
+ * its key with each group's key; past it a hash table is used instead.
+ */
+#define JSON_KEY_MAX_LINEAR_GROUPS 16
+
 /**
  * Groups the children of a node by their json key. Children are put in the same group if they have the same json key.
  * @return Linked list where each element is another linked list of nodes associated with the same json key.
@@ -1077,44 +1083,75 @@ GSList *
 proto_node_group_children_by_json_key(proto_node *node)
 {
     /**
-     * For each different json key we store a linked list of values corresponding to that json key. These lists are kept
-     * in both a linked list and a hashmap. The hashmap is used to quickly retrieve the values of a json key. The linked
-     * list is used to preserve the ordering of keys as they are encountered which is not guaranteed when only using a
-     * hashmap.
+     * Children are collected per json key in order of first appearance. Most nodes only have a handful of
+     * children, so rather than building a hash table for every node, the group of a child is looked up with a
+     * linear scan, and the hash table is only filled in once a node turns out to have many distinct keys. The
+     * arrays and the hash table are kept between calls and only emptied, as this is called for every node of
+     * every packet.
      */
+    static GPtrArray *group_keys = NULL;    /* json key of each group */
+    static GPtrArray *groups = NULL;        /* GSList of the group's nodes, in reverse order */
+    static GHashTable *lookup_by_json_key = NULL;   /* json key -> group index */
+    gboolean use_lookup = FALSE;
     GSList *same_key_nodes_list = NULL;
-    GHashTable *lookup_by_json_key = g_hash_table_new(g_str_hash, g_str_equal);
-    proto_node *current_child = node->first_child;
+    proto_node *current_child;
+    guint group, i;
 
-    /**
-     * For each child of the node get the key and get the list of values already associated with that key from the
-     * hashmap. If no list exist yet for that key create a new one and add it to both the linked list and hashmap. If a
-     * list already exists add the node to that list.
-     */
-    while (current_child != NULL) {
-        char *json_key = (char *) proto_node_to_json_key(current_child);
-        GSList *json_key_nodes = (GSList *) g_hash_table_lookup(lookup_by_json_key, json_key);
-
-        if (json_key_nodes == NULL) {
-            json_key_nodes = g_slist_append(json_key_nodes, current_child);
-            // Prepending in single linked list is O(1), appending is O(n). Better to prepend here and reverse at the
-            // end than potentially looping to the end of the linked list for each child.
-            same_key_nodes_list = g_slist_prepend(same_key_nodes_list, json_key_nodes);
-            g_hash_table_insert(lookup_by_json_key, json_key, json_key_nodes);
+    if (groups == NULL) {
+        group_keys = g_ptr_array_new();
+        groups = g_ptr_array_new();
+        lookup_by_json_key = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+
+    for (current_child = node->first_child; current_child != NULL; current_child = current_child->next) {
+        const char *json_key = proto_node_to_json_key(current_child);
+        gpointer group_idx;
+
+        group = groups->len;
+        if (use_lookup) {
+            if (g_hash_table_lookup_extended(lookup_by_json_key, json_key, NULL, &group_idx)) {
+                group = GPOINTER_TO_UINT(group_idx);
+            }
         } else {
-            // Store and insert value again to circumvent unused_variable warning.
-            // Append in this case since most value lists will only have a single value.
-            json_key_nodes = g_slist_append(json_key_nodes, current_child);
-            g_hash_table_insert(lookup_by_json_key, json_key, json_key_nodes);
+            for (i = 0; i < group_keys->len; i++) {
+                const char *group_key = (const char *) g_ptr_array_index(group_keys, i);
+                // Keys are usually the same hfinfo abbrev, so try the pointer first.
+                if (group_key == json_key || strcmp(group_key, json_key) == 0) {
+                    group = i;
+                    break;
+                }
+            }
         }
 
-        current_child = current_child->next;
+        if (group == groups->len) {
+            g_ptr_array_add(group_keys, (gpointer) json_key);
+            g_ptr_array_add(groups, NULL);
+            if (use_lookup) {
+                g_hash_table_insert(lookup_by_json_key, (gpointer) json_key, GUINT_TO_POINTER(group));
+            } else if (groups->len > JSON_KEY_MAX_LINEAR_GROUPS) {
+                use_lookup = TRUE;
+                for (i = 0; i < group_keys->len; i++) {
+                    g_hash_table_insert(lookup_by_json_key, g_ptr_array_index(group_keys, i), GUINT_TO_POINTER(i));
+                }
+            }
+        }
+
+        // Prepending in single linked list is O(1), appending is O(n). Better to prepend here and reverse at the
+        // end than potentially looping to the end of the linked list for each child.
+        groups->pdata[group] = g_slist_prepend((GSList *) groups->pdata[group], current_child);
     }
 
-    // Hash table is not needed anymore since the linked list with the correct ordering is returned.
-    g_hash_table_destroy(lookup_by_json_key);
+    for (i = groups->len; i > 0; i--) {
+        same_key_nodes_list = g_slist_prepend(same_key_nodes_list, g_slist_reverse((GSList *) groups->pdata[i - 1]));
+    }
+
+    g_ptr_array_set_size(group_keys, 0);
+    g_ptr_array_set_size(groups, 0);
+    if (use_lookup) {
+        g_hash_table_remove_all(lookup_by_json_key);
+    }
 
-    return g_slist_reverse(same_key_nodes_list);
+    return same_key_nodes_list;
 }
 
 /**
@@ -329,6 +329,7 @@ struct _protocol {
                                        can be added to a dissector table, but use the
                                        parent_proto_id for things like enable/disable */
 	GList      *heur_list;          /* Heuristic dissectors associated with this protocol */
+	prefix_initializer_t deferred_fields; /* Registers the fields on first use, if not done yet */
 };
 
 /* List of all protocols */
@@ -342,6 +343,9 @@ static GPtrArray *deregistered_data = NULL;
 /* indexed by prefix, contains initializers */
 static GHashTable* prefixes = NULL;
 
+/* number of protocols whose fields have not been registered yet */
+static guint deferred_fields_count = 0;
+
 /* Contains information about a field when a dissector calls
  * proto_tree_add_item.  */
 #define FIELD_INFO_NEW(pool, fi)  fi = wmem_new(pool, field_info)
@@ -615,6 +619,7 @@ proto_cleanup_base(void)
 
 	if (prefixes)
 		g_hash_table_destroy(prefixes);
+	deferred_fields_count = 0;
 }
 
 void
@@ -908,7 +913,48 @@ initialize_prefix(gpointer k, gpointer v, gpointer u _U_) {
 /** Initialize every remaining uninitialized prefix. */
 void
 proto_initialize_all_prefixes(void) {
-	g_hash_table_foreach_remove(prefixes, initialize_prefix, NULL);
+	if (prefixes)
+		g_hash_table_foreach_remove(prefixes, initialize_prefix, NULL);
+}
+
+/* Prefix initializer for protocols registered with
+ * proto_register_fields_deferred(); the caller takes care of the
+ * prefixes table. */
+static void
+initialize_deferred_fields(const char *match) {
+	gchar      *filter_name = g_strndup(match, strcspn(match, "."));
+	protocol_t *protocol    = (protocol_t *)g_hash_table_lookup(proto_filter_names, filter_name);
+	prefix_initializer_t pi;
+
+	g_free(filter_name);
+	if (!protocol || !protocol->deferred_fields)
+		return;
+
+	pi = protocol->deferred_fields;
+	protocol->deferred_fields = NULL;
+	deferred_fields_count--;
+	pi(protocol->filter_name);
+}
+
+/* Register a protocol's fields on first use rather than at startup */
+void
+proto_register_fields_deferred(const int parent, prefix_initializer_t initializer) {
+	protocol_t *protocol = find_protocol_by_id(parent);
+
+	DISSECTOR_ASSERT(protocol && !protocol->deferred_fields);
+
+	protocol->deferred_fields = initializer;
+	deferred_fields_count++;
+	proto_register_prefix(protocol->filter_name, initialize_deferred_fields);
+}
+
+void
+proto_initialize_deferred_fields(protocol_t *protocol) {
+	if (G_LIKELY(deferred_fields_count == 0) || !protocol->deferred_fields)
+		return;
+
+	g_hash_table_remove(prefixes, protocol->filter_name);
+	initialize_deferred_fields(protocol->filter_name);
 }
 
 /* Finds a record in the hfinfo array by name.
@@ -6733,6 +6779,7 @@ proto_register_protocol(const char *name, const char *short_name,
 	protocol->can_toggle = TRUE;
 	protocol->parent_proto_id = -1;
 	protocol->heur_list = NULL;
+	protocol->deferred_fields = NULL;
 
 	/* List will be sorted later by name, when all protocols completed registering */
 	protocols = g_list_prepend(protocols, protocol);
@@ -6792,6 +6839,7 @@ proto_register_protocol_in_name_only(const char *name, const char *short_name, c
 
 	protocol->parent_proto_id = parent_proto;
 	protocol->heur_list = NULL;
+	protocol->deferred_fields = NULL;
 
 	/* List will be sorted later by name, when all protocols completed registering */
 	pino_protocols = g_list_prepend(pino_protocols, protocol);
@@ -6832,6 +6880,12 @@ proto_deregister_protocol(const char *short_name)
 	g_hash_table_remove(proto_short_names, (gpointer)short_name);
 	g_hash_table_remove(proto_filter_names, (gpointer)protocol->filter_name);
 
+	if (protocol->deferred_fields) {
+		g_hash_table_remove(prefixes, protocol->filter_name);
+		protocol->deferred_fields = NULL;
+		deferred_fields_count--;
+	}
+
 	if (protocol->fields) {
 		for (i = 0; i < protocol->fields->len; i++) {
 			hfinfo = (header_field_info *)g_ptr_array_index(protocol->fields, i);
@@ -2223,6 +2223,21 @@ proto_register_prefix(const char *prefix,  prefix_initializer_t initializer);
 /** Initialize every remaining uninitialized prefix. */
 WS_DLL_PUBLIC void proto_initialize_all_prefixes(void);
 
+/** Register the fields of a protocol the first time they are needed instead
+    of at startup. Unlike proto_register_prefix(), the initializer is also
+    called before any of the protocol's dissectors or heuristic dissectors
+    is first called, so the dissectors need not check for it themselves.
+@param parent the protocol handle from proto_register_protocol()
+@param initializer function that registers the protocol's hf and ett arrays */
+WS_DLL_PUBLIC void
+proto_register_fields_deferred(const int parent, prefix_initializer_t initializer);
+
+/** Register the fields of the given protocol now, if they were deferred with
+    proto_register_fields_deferred() and have not been registered yet.
+@param protocol the protocol */
+WS_DLL_PUBLIC void
+proto_initialize_deferred_fields(protocol_t *protocol);
+
 WS_DLL_PUBLIC void proto_register_fields_manual(const int parent, header_field_info **hfi, const int num_records);
 WS_DLL_PUBLIC void proto_register_fields_section(const int parent, header_field_info *hfi, const int num_records);
 
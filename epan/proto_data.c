@@ -11,6 +11,7 @@
 #include "config.h"
 
 #include <glib.h>
+#include <string.h>
 
 #if 0
 #include <epan/epan.h>
@@ -35,116 +36,205 @@ typedef struct _proto_data {
   void *proto_data;
 } proto_data_t;
 
-static gint
-p_compare(gconstpointer a, gconstpointer b)
+/* The proto data of a frame or packet: the entries in the order they were
+   added. Most packets only get a few, so they start out in the table itself
+   and are scanned linearly; past PROTO_DATA_LINEAR_MAX entries an
+   open-addressed index by (proto, key) is built over them so that lookups
+   don't depend on how many entries there are. Everything is allocated in
+   the scope the data belongs to. */
+#define PROTO_DATA_INLINE_ENTRIES   2
+#define PROTO_DATA_LINEAR_MAX       8
+
+struct _proto_data_table {
+  proto_data_t *entries;      /* inline_entries until they overflow */
+  guint32      *slots;        /* index into entries + 1, 0 if free; NULL
+                                 while there is no index */
+  guint         count;
+  guint         entries_size;
+  guint         slots_mask;   /* number of slots - 1, a power of 2 */
+  proto_data_t  inline_entries[PROTO_DATA_INLINE_ENTRIES];
+};
+
+static inline guint
+p_hash(int proto, guint32 key)
 {
-  const proto_data_t *ap = (const proto_data_t *)a;
-  const proto_data_t *bp = (const proto_data_t *)b;
-
-  if (ap -> proto > bp -> proto) {
-    return 1;
-  } else if (ap -> proto == bp -> proto) {
-    if (ap->key > bp->key){
-      return 1;
-    } else if (ap -> key == bp -> key) {
-      return 0;
-    }
-    return -1;
+  guint32 h = ((guint32)proto * 0x9E3779B1U) ^ key;
+
+  h ^= h >> 16;
+  h *= 0x85EBCA6BU;
+  h ^= h >> 13;
+  return h;
+}
+
+/* Returns the slot holding (proto, key), or the free slot it would go in. */
+static guint
+p_find_slot(const proto_data_table_t *table, int proto, guint32 key)
+{
+  guint         i;
+  guint32       s;
+  proto_data_t *p1;
+
+  for (i = p_hash(proto, key) & table->slots_mask; ; i = (i + 1) & table->slots_mask) {
+    s = table->slots[i];
+    if (s == 0)
+      return i;
+    p1 = &table->entries[s - 1];
+    if (p1->proto == proto && p1->key == key)
+      return i;
+  }
+}
+
+/* Returns the index of (proto, key) in the entries + 1, 0 if it isn't there. */
+static guint
+p_find_entry(const proto_data_table_t *table, int proto, guint32 key)
+{
+  guint i;
+
+  if (table->slots)
+    return table->slots[p_find_slot(table, proto, key)];
+
+  for (i = 0; i < table->count; i++) {
+    if (table->entries[i].proto == proto && table->entries[i].key == key)
+      return i + 1;
+  }
+  return 0;
+}
+
+static void
+p_rebuild_slots(wmem_allocator_t *scope, proto_data_table_t *table, guint n_slots)
+{
+  guint i;
+
+  if (table->slots == NULL || n_slots != table->slots_mask + 1) {
+    wmem_free(scope, table->slots);
+    table->slots = wmem_alloc0_array(scope, guint32, n_slots);
+    table->slots_mask = n_slots - 1;
   } else {
-    return -1;
+    memset(table->slots, 0, n_slots * sizeof *table->slots);
+  }
+  for (i = 0; i < table->count; i++) {
+    table->slots[p_find_slot(table, table->entries[i].proto, table->entries[i].key)] = i + 1;
   }
 }
 
+static proto_data_table_t **
+p_get_table(wmem_allocator_t *scope, struct _packet_info* pinfo)
+{
+  if (scope == pinfo->pool) {
+    return &pinfo->proto_data;
+  } else if (scope == wmem_file_scope()) {
+    return &pinfo->fd->pfd;
+  }
+  DISSECTOR_ASSERT(!"invalid wmem scope");
+  return NULL;
+}
+
 void
 p_add_proto_data(wmem_allocator_t *tmp_scope, struct _packet_info* pinfo, int proto, guint32 key, void *proto_data)
 {
-  proto_data_t     *p1;
-  GSList          **proto_list;
-  wmem_allocator_t *scope;
-
-  if (tmp_scope == pinfo->pool) {
-    scope = tmp_scope;
-    proto_list = &pinfo->proto_data;
-  } else if (tmp_scope == wmem_file_scope()) {
-    scope = wmem_file_scope();
-    proto_list = &pinfo->fd->pfd;
-  } else {
-    DISSECTOR_ASSERT(!"invalid wmem scope");
+  proto_data_table_t **table_ptr = p_get_table(tmp_scope, pinfo);
+  proto_data_table_t  *table = *table_ptr;
+  proto_data_t        *p1;
+  guint                n_slots;
+  guint                s;
+
+  if (table == NULL) {
+    table = wmem_new(tmp_scope, proto_data_table_t);
+    table->entries = table->inline_entries;
+    table->slots = NULL;
+    table->count = 0;
+    table->entries_size = PROTO_DATA_INLINE_ENTRIES;
+    table->slots_mask = 0;
+    *table_ptr = table;
   }
 
-  p1 = (proto_data_t *)wmem_alloc(scope, sizeof(proto_data_t));
+  s = p_find_entry(table, proto, key);
+  if (s != 0) {
+    /* Replace the data previously added for this proto and key */
+    table->entries[s - 1].proto_data = proto_data;
+    return;
+  }
 
+  if (table->count == table->entries_size) {
+    table->entries_size *= 2;
+    if (table->entries == table->inline_entries) {
+      table->entries = wmem_alloc_array(tmp_scope, proto_data_t, table->entries_size);
+      memcpy(table->entries, table->inline_entries, sizeof table->inline_entries);
+    } else {
+      table->entries = (proto_data_t *)wmem_realloc(tmp_scope, table->entries,
+          table->entries_size * sizeof(proto_data_t));
+    }
+  }
+
+  p1 = &table->entries[table->count];
   p1->proto = proto;
   p1->key = key;
   p1->proto_data = proto_data;
-
-  /* Add it to the GSLIST */
-  *proto_list = g_slist_prepend(*proto_list, p1);
+  table->count++;
+
+  if (table->slots) {
+    /* Keep the index at most half full */
+    if (table->count * 2 > table->slots_mask + 1)
+      p_rebuild_slots(tmp_scope, table, (table->slots_mask + 1) * 2);
+    else
+      table->slots[p_find_slot(table, proto, key)] = table->count;
+  } else if (table->count > PROTO_DATA_LINEAR_MAX) {
+    for (n_slots = PROTO_DATA_LINEAR_MAX * 2; n_slots < table->count * 2; n_slots *= 2)
+      ;
+    p_rebuild_slots(tmp_scope, table, n_slots);
+  }
 }
 
 void *
 p_get_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key)
 {
-  proto_data_t  temp, *p1;
-  GSList       *item;
+  proto_data_table_t *table = *p_get_table(scope, pinfo);
+  guint               s;
 
-  temp.proto = proto;
-  temp.key = key;
-  temp.proto_data = NULL;
+  if (table == NULL)
+    return NULL;
 
-  if (scope == pinfo->pool) {
-    item = g_slist_find_custom(pinfo->proto_data, &temp, p_compare);
-  } else if (scope == wmem_file_scope()) {
-    item = g_slist_find_custom(pinfo->fd->pfd, &temp, p_compare);
-  } else {
-    DISSECTOR_ASSERT(!"invalid wmem scope");
-  }
-
-  if (item) {
-    p1 = (proto_data_t *)item->data;
-    return p1->proto_data;
-  }
-
-  return NULL;
+  s = p_find_entry(table, proto, key);
+  return s ? table->entries[s - 1].proto_data : NULL;
 }
 
 void
 p_remove_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key)
 {
-  proto_data_t  temp;
-  GSList       *item;
-  GSList      **proto_list;
-
-  temp.proto = proto;
-  temp.key = key;
-  temp.proto_data = NULL;
+  proto_data_table_t *table = *p_get_table(scope, pinfo);
+  guint               s;
+
+  if (table == NULL)
+    return;
+
+  s = p_find_entry(table, proto, key);
+  if (s == 0)
+    return;
+
+  /* Rare enough that keeping the entries in order and rebuilding the
+     index is fine */
+  memmove(&table->entries[s - 1], &table->entries[s],
+      (table->count - s) * sizeof(proto_data_t));
+  table->count--;
+  if (table->slots)
+    p_rebuild_slots(scope, table, table->slots_mask + 1);
+}
 
-  if (scope == pinfo->pool) {
-    item = g_slist_find_custom(pinfo->proto_data, &temp, p_compare);
-    proto_list = &pinfo->proto_data;
-  } else if (scope == wmem_file_scope()) {
-    item = g_slist_find_custom(pinfo->fd->pfd, &temp, p_compare);
-    proto_list = &pinfo->fd->pfd;
-  } else {
-    DISSECTOR_ASSERT(!"invalid wmem scope");
-  }
+guint
+p_get_proto_data_count(wmem_allocator_t *scope, struct _packet_info* pinfo)
+{
+  proto_data_table_t *table = *p_get_table(scope, pinfo);
 
-  if (item) {
-    *proto_list = g_slist_remove(*proto_list, item->data);
-  }
+  return table ? table->count : 0;
 }
 
 gchar *
 p_get_proto_name_and_key(wmem_allocator_t *scope, struct _packet_info* pinfo, guint pfd_index){
-  proto_data_t  *temp;
+  proto_data_table_t *table = *p_get_table(scope, pinfo);
+  proto_data_t       *temp;
 
-  if (scope == pinfo->pool) {
-    temp = (proto_data_t *)g_slist_nth_data(pinfo->proto_data, pfd_index);
-  } else if (scope == wmem_file_scope()) {
-    temp = (proto_data_t *)g_slist_nth_data(pinfo->fd->pfd, pfd_index);
-  } else {
-    DISSECTOR_ASSERT(!"invalid wmem scope");
-  }
+  DISSECTOR_ASSERT(table != NULL && pfd_index < table->count);
+  temp = &table->entries[pfd_index];
 
   return wmem_strdup_printf(wmem_packet_scope(),"[%s, key %u]",proto_get_protocol_name(temp->proto), temp->key);
 }
@@ -17,10 +17,15 @@ extern "C" {
 
 #include "ws_symbol_export.h"
 
-/* Allocator should be either pinfo->pool or wmem_file_scope() */
+/* Per-packet or per-frame proto data, see pinfo->proto_data and fd->pfd */
+typedef struct _proto_data_table proto_data_table_t;
+
+/* Allocator should be either pinfo->pool or wmem_file_scope().
+   Adding data for a proto and key that already have some replaces it. */
 WS_DLL_PUBLIC void p_add_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key, void *proto_data);
 WS_DLL_PUBLIC void *p_get_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key);
 WS_DLL_PUBLIC void p_remove_proto_data(wmem_allocator_t *scope, struct _packet_info* pinfo, int proto, guint32 key);
+WS_DLL_PUBLIC guint p_get_proto_data_count(wmem_allocator_t *scope, struct _packet_info* pinfo);
 gchar *p_get_proto_name_and_key(wmem_allocator_t *scope, struct _packet_info* pinfo, guint pfd_index);
 
 #ifdef __cplusplus
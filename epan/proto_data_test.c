@@ -0,0 +1,198 @@
+/* proto_data_test.c
+ * Standalone program to test the per-packet and per-frame proto data API,
+ * and to time its lookups.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <epan/packet_info.h>
+#include <epan/proto_data.h>
+#include <epan/wmem/wmem.h>
+
+static packet_info pinfo;
+static frame_data  fd;
+
+static void
+setup_pinfo(wmem_allocator_type_t type)
+{
+    memset(&pinfo, 0, sizeof pinfo);
+    memset(&fd, 0, sizeof fd);
+    pinfo.fd = &fd;
+    pinfo.pool = wmem_allocator_new(type);
+}
+
+static void
+teardown_pinfo(void)
+{
+    wmem_destroy_allocator(pinfo.pool);
+}
+
+static void
+test_add_get(void)
+{
+    int    a = 1, b = 2, c = 3;
+    guint  i;
+
+    setup_pinfo(WMEM_ALLOCATOR_STRICT);
+
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, 0) == NULL);
+    g_assert_cmpuint(p_get_proto_data_count(pinfo.pool, &pinfo), ==, 0);
+
+    p_add_proto_data(pinfo.pool, &pinfo, 10, 0, &a);
+    p_add_proto_data(pinfo.pool, &pinfo, 10, 1, &b);
+    p_add_proto_data(pinfo.pool, &pinfo, 11, 0, &c);
+
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, 0) == &a);
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, 1) == &b);
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 11, 0) == &c);
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 11, 1) == NULL);
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 12, 0) == NULL);
+    g_assert_cmpuint(p_get_proto_data_count(pinfo.pool, &pinfo), ==, 3);
+
+    /* Adding again replaces */
+    p_add_proto_data(pinfo.pool, &pinfo, 10, 1, &c);
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, 1) == &c);
+    g_assert_cmpuint(p_get_proto_data_count(pinfo.pool, &pinfo), ==, 3);
+
+    /* Enough to grow the table several times */
+    for (i = 0; i < 1000; i++) {
+        p_add_proto_data(pinfo.pool, &pinfo, 100 + (i % 7), i, GUINT_TO_POINTER(i + 1));
+    }
+    for (i = 0; i < 1000; i++) {
+        g_assert(p_get_proto_data(pinfo.pool, &pinfo, 100 + (i % 7), i) == GUINT_TO_POINTER(i + 1));
+        g_assert(p_get_proto_data(pinfo.pool, &pinfo, 100 + ((i + 1) % 7), i) == NULL);
+    }
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, 0) == &a);
+    g_assert_cmpuint(p_get_proto_data_count(pinfo.pool, &pinfo), ==, 1003);
+
+    /* The per-frame data is separate */
+    g_assert(fd.pfd == NULL);
+
+    teardown_pinfo();
+}
+
+static void
+test_remove(void)
+{
+    guint i;
+
+    setup_pinfo(WMEM_ALLOCATOR_STRICT);
+
+    /* Removing from an empty packet is fine */
+    p_remove_proto_data(pinfo.pool, &pinfo, 10, 0);
+
+    /* A few entries, before there is an index over them */
+    for (i = 0; i < 4; i++) {
+        p_add_proto_data(pinfo.pool, &pinfo, 20, i, GUINT_TO_POINTER(i + 1));
+    }
+    p_remove_proto_data(pinfo.pool, &pinfo, 20, 1);
+    g_assert_cmpuint(p_get_proto_data_count(pinfo.pool, &pinfo), ==, 3);
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 20, 0) == GUINT_TO_POINTER(1));
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 20, 1) == NULL);
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 20, 3) == GUINT_TO_POINTER(4));
+    for (i = 0; i < 4; i++) {
+        p_remove_proto_data(pinfo.pool, &pinfo, 20, i);
+    }
+    g_assert_cmpuint(p_get_proto_data_count(pinfo.pool, &pinfo), ==, 0);
+
+    for (i = 0; i < 20; i++) {
+        p_add_proto_data(pinfo.pool, &pinfo, 10, i, GUINT_TO_POINTER(i + 1));
+    }
+    for (i = 0; i < 20; i += 2) {
+        p_remove_proto_data(pinfo.pool, &pinfo, 10, i);
+    }
+    p_remove_proto_data(pinfo.pool, &pinfo, 10, 100);
+    g_assert_cmpuint(p_get_proto_data_count(pinfo.pool, &pinfo), ==, 10);
+
+    for (i = 0; i < 20; i++) {
+        if (i % 2) {
+            g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, i) == GUINT_TO_POINTER(i + 1));
+        } else {
+            g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, i) == NULL);
+        }
+    }
+
+    /* And it can be added back */
+    p_add_proto_data(pinfo.pool, &pinfo, 10, 4, GUINT_TO_POINTER(42));
+    g_assert(p_get_proto_data(pinfo.pool, &pinfo, 10, 4) == GUINT_TO_POINTER(42));
+
+    teardown_pinfo();
+}
+
+/* Time lookups with different numbers of entries; the cost per lookup
+ * should not grow with them. */
+static void
+test_lookup_perf(void)
+{
+    static const guint counts[] = { 1, 4, 16, 64, 256 };
+    const guint        lookups = 1000000;
+    guint              c, i, n;
+    gsize              found;
+    gdouble            elapsed, ns;
+
+    for (c = 0; c < G_N_ELEMENTS(counts); c++) {
+        n = counts[c];
+        setup_pinfo(WMEM_ALLOCATOR_BLOCK_FAST);
+
+        for (i = 0; i < n; i++) {
+            p_add_proto_data(pinfo.pool, &pinfo, 1000 + i, i % 4, GUINT_TO_POINTER(i + 1));
+        }
+
+        found = 0;
+        g_test_timer_start();
+        for (i = 0; i < lookups; i++) {
+            found += GPOINTER_TO_UINT(p_get_proto_data(pinfo.pool, &pinfo, 1000 + (i % n), (i % n) % 4)) != 0;
+        }
+        elapsed = g_test_timer_elapsed();
+        g_assert_cmpuint(found, ==, lookups);
+
+        ns = elapsed * 1e9 / lookups;
+        g_test_minimized_result(ns, "%4u entries: %.1f ns per lookup", n, ns);
+        teardown_pinfo();
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    int ret;
+
+    wmem_init();
+
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/proto_data/add_get", test_add_get);
+    g_test_add_func("/proto_data/remove", test_remove);
+    if (g_test_perf()) {
+        g_test_add_func("/proto_data/lookup_perf", test_lookup_perf);
+    }
+
+    ret = g_test_run();
+
+    wmem_cleanup();
+
+    return ret;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -89,13 +89,24 @@ stats_tree_branch_max_namelen(const stat_node *node, guint indent)
     return maxlen;
 }
 
+/* drops the burst window of a node; it is reallocated on the next update */
+static void
+reset_burst_calc(stat_node *node)
+{
+    g_free(node->burst_counts);
+    g_free(node->burst_starts);
+    node->burst_counts = NULL;
+    node->burst_starts = NULL;
+    node->burst_size = 0;
+    node->burst_newest = 0;
+}
+
 /* frees the resources allocated by a stat_tree node */
 static void
 free_stat_node(stat_node *node)
 {
     stat_node *child;
     stat_node *next;
-    burst_bucket *bucket;
 
     if (node->children) {
     for (child = node->children; child; child = next ) {
@@ -107,11 +118,8 @@ free_stat_node(stat_node *node)
 
     if (node->hash) g_hash_table_destroy(node->hash);
 
-    while (node->bh) {
-        bucket = node->bh;
-        node->bh = bucket->next;
-        g_free(bucket);
-    }
+    g_free(node->burst_counts);
+    g_free(node->burst_starts);
 
     g_free(node->rng);
     g_free(node->name);
@@ -153,7 +161,6 @@ static void
 reset_stat_node(stat_node *node)
 {
     stat_node *child;
-    burst_bucket *bucket;
 
     node->counter = 0;
     node->total = 0;
@@ -161,13 +168,7 @@ reset_stat_node(stat_node *node)
     node->maxvalue = G_MININT;
     node->st_flags = 0;
 
-    while (node->bh) {
-        bucket = node->bh;
-        node->bh = bucket->next;
-        g_free(bucket);
-    }
-    node->bh = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
-    node->bt = node->bh;
+    reset_burst_calc(node);
     node->bcount = 0;
     node->max_burst = 0;
     node->burst_time = -1.0;
@@ -211,8 +212,7 @@ stats_tree_reinit(void *p)
     st->root.maxvalue = G_MININT;
     st->root.st_flags = 0;
 
-    st->root.bh = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
-    st->root.bt = st->root.bh;
+    reset_burst_calc(&st->root);
     st->root.bcount = 0;
     st->root.max_burst = 0;
     st->root.burst_time = -1.0;
@@ -320,8 +320,6 @@ stats_tree_new(stats_tree_cfg *cfg, tree_pres *pr, const char *filter)
     st->root.minvalue = G_MAXINT;
     st->root.maxvalue = G_MININT;
 
-    st->root.bh = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
-    st->root.bt = st->root.bh;
     st->root.burst_time = -1.0;
 
     st->root.name = stats_tree_get_displayname(cfg->name);
@@ -440,8 +438,6 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id,
     node->maxvalue = G_MININT;
     node->st_flags = parent_id?0:ST_FLG_ROOTCHILD;
 
-    node->bh = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
-    node->bt = node->bh;
     node->burst_time = -1.0;
 
     node->name = g_strdup(name);
@@ -514,119 +510,98 @@ stats_tree_create_node_by_pname(stats_tree *st, const gchar *name,
     return stats_tree_create_node(st,name,stats_tree_parent_id_by_name(st,parent_name),with_children);
 }
 
-/* Internal function to update the burst calculation data - add entry to bucket */
+/* Index of a bucket in the circular burst arrays of a node */
+static inline int
+burst_slot(const stat_node *node, gint64 bucket_no)
+{
+    int slot = (int)(bucket_no % node->burst_size);
+
+    return slot < 0 ? slot + node->burst_size : slot;
+}
+
+/* Internal function to update the burst calculation data - add entry to bucket.
+ * The window holds the burst_size most recent buckets, so each node only needs
+ * two fixed-size arrays, allocated on first use. A bucket whose start time is
+ * negative is empty. */
 static void
 update_burst_calc(stat_node *node, gint value)
 {
-    double current_bucket;
-    double burstwin;
-
-    burst_bucket *bn;
+    gint64 current_bucket;
+    gint64 bucket_no;
+    gint burstwin;
+    int slot, i;
 
     if (!prefs.st_enable_burstinfo) {
         return;
     }
 
-    /* NB thebucket list should always contain at least one node - even if it is */
-    /* the dummy created at init time. Head and tail should never be NULL!       */
-    current_bucket = floor(node->st->now/prefs.st_burst_resolution);
+    current_bucket = (gint64)floor(node->st->now/prefs.st_burst_resolution);
     burstwin = prefs.st_burst_windowlen/prefs.st_burst_resolution;
-    if (current_bucket>node->bt->bucket_no) {
-        /* Must add a new bucket at the burst list tail */
-        bn = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
-        bn->count = value;
-        bn->bucket_no = current_bucket;
-        bn->start_time = node->st->now;
-        bn->prev = node->bt;
-        node->bt->next = bn;
-        node->bt = bn;
-        /* And add value to the current burst count for node */
-        node->bcount += value;
-        /* Check if bucket list head is now too old and must be removed */
-        while (current_bucket>=(node->bh->bucket_no+burstwin)) {
-            /* off with its head! */
-            bn = node->bh;
-            node->bh = bn->next;
-            node->bh->prev = NULL;
-            node->bcount -= bn->count;
-            g_free(bn);
-        }
+    if (burstwin < 1) {
+        burstwin = 1;
     }
-    else if (current_bucket<node->bh->bucket_no) {
-        /* Packet must be added at head of burst list - check if not too old */
-        if ((current_bucket+burstwin)>node->bt->bucket_no) {
-            /* packet still within the window */
-            bn = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
-            bn->count = value;
-            bn->bucket_no = current_bucket;
-            bn->start_time = node->st->now;
-            bn->next = node->bh;
-            node->bh->prev = bn;
-            node->bh = bn;
-            /* And add value to the current burst count for node */
-            node->bcount += value;
+
+    if (node->burst_size != burstwin) {
+        /* First update, or the window size preference changed */
+        g_free(node->burst_counts);
+        g_free(node->burst_starts);
+        node->burst_counts = g_new0(gint, burstwin);
+        node->burst_starts = g_new(double, burstwin);
+        for (i = 0; i < burstwin; i++) {
+            node->burst_starts[i] = -1.0;
         }
+        node->burst_size = burstwin;
+        node->burst_newest = current_bucket;
+        node->bcount = 0;
     }
-    else
-    {
-        /* Somewhere in the middle... */
-        burst_bucket *search = node->bt;
-        while (current_bucket<search->bucket_no) {
-            search = search->prev;
-        }
-        if (current_bucket==search->bucket_no) {
-            /* found existing bucket, increase value */
-            search->count += value;
-            if (search->start_time>node->st->now) {
-                search->start_time = node->st->now;
+
+    if (current_bucket > node->burst_newest) {
+        /* Moving forward - empty the buckets that fall out of the window */
+        if (current_bucket - node->burst_newest >= burstwin) {
+            memset(node->burst_counts, 0, burstwin * sizeof(gint));
+            for (i = 0; i < burstwin; i++) {
+                node->burst_starts[i] = -1.0;
+            }
+            node->bcount = 0;
+        } else {
+            for (bucket_no = node->burst_newest + 1; bucket_no <= current_bucket; bucket_no++) {
+                slot = burst_slot(node, bucket_no);
+                node->bcount -= node->burst_counts[slot];
+                node->burst_counts[slot] = 0;
+                node->burst_starts[slot] = -1.0;
             }
         }
-        else {
-            /* must add a new bucket after bn. */
-            bn = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
-            bn->count = value;
-            bn->bucket_no = current_bucket;
-            bn->start_time = node->st->now;
-            bn->prev = search;
-            bn->next = search->next;
-            search->next = bn;
-            bn->next->prev = bn;
-        }
-        node->bcount += value;
+        node->burst_newest = current_bucket;
+    }
+    else if (current_bucket <= node->burst_newest - burstwin) {
+        /* Packet too old to be within the window */
+        return;
+    }
+
+    slot = burst_slot(node, current_bucket);
+    node->burst_counts[slot] += value;
+    if (node->burst_starts[slot] < 0 || node->burst_starts[slot] > node->st->now) {
+        node->burst_starts[slot] = node->st->now;
     }
+    node->bcount += value;
+
     if (node->bcount>node->max_burst) {
-        /* new record burst */
+        /* new record burst, starting at the oldest bucket in the window */
         node->max_burst = node->bcount;
-        node->burst_time = node->bh->start_time;
+        for (bucket_no = node->burst_newest - burstwin + 1; bucket_no <= node->burst_newest; bucket_no++) {
+            slot = burst_slot(node, bucket_no);
+            if (node->burst_starts[slot] >= 0) {
+                node->burst_time = node->burst_starts[slot];
+                break;
+            }
+        }
     }
 }
 
-/*
- * Increases by delta the counter of the node whose name is given
- * if the node does not exist yet it's created (with counter=1)
- * using parent_name as parent node.
- * with_hash=TRUE to indicate that the created node will have a parent
- */
-extern int
-stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
-              int parent_id, gboolean with_hash, gint value)
+/* applies a manip_node_mode change to a node */
+static void
+manip_stat_node(manip_node_mode mode, stat_node *node, gint value)
 {
-    stat_node *node = NULL;
-    stat_node *parent = NULL;
-
-    g_assert( parent_id >= 0 && parent_id < (int) st->parents->len );
-
-    parent = (stat_node *)g_ptr_array_index(st->parents,parent_id);
-
-    if( parent->hash ) {
-        node = (stat_node *)g_hash_table_lookup(parent->hash,name);
-    } else {
-        node = (stat_node *)g_hash_table_lookup(st->names,name);
-    }
-
-    if ( node == NULL )
-        node = new_stat_node(st,name,parent_id,with_hash,with_hash);
-
     switch (mode) {
         case MN_INCREASE:
             node->counter += value;
@@ -654,6 +629,35 @@ stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
             node->st_flags &= ~value;
             break;
     }
+}
+
+/*
+ * Increases by delta the counter of the node whose name is given
+ * if the node does not exist yet it's created (with counter=1)
+ * using parent_name as parent node.
+ * with_hash=TRUE to indicate that the created node will have a parent
+ */
+extern int
+stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
+              int parent_id, gboolean with_hash, gint value)
+{
+    stat_node *node = NULL;
+    stat_node *parent = NULL;
+
+    g_assert( parent_id >= 0 && parent_id < (int) st->parents->len );
+
+    parent = (stat_node *)g_ptr_array_index(st->parents,parent_id);
+
+    if( parent->hash ) {
+        node = (stat_node *)g_hash_table_lookup(parent->hash,name);
+    } else {
+        node = (stat_node *)g_hash_table_lookup(st->names,name);
+    }
+
+    if ( node == NULL )
+        node = new_stat_node(st,name,parent_id,with_hash,with_hash);
+
+    manip_stat_node(mode, node, value);
 
     if (node)
         return node->id;
@@ -661,6 +665,26 @@ stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
         return -1;
 }
 
+/*
+ * Same as stats_tree_manip_node(), for a node already created with
+ * stats_tree_create_node() or returned by an earlier call that created
+ * it with children. The node is found by indexing rather than by
+ * hashing its name.
+ */
+extern int
+stats_tree_manip_node_by_id(manip_node_mode mode, stats_tree *st, int node_id,
+              gint value)
+{
+    stat_node *node;
+
+    g_assert( node_id >= 0 && node_id < (int) st->parents->len );
+
+    node = (stat_node *)g_ptr_array_index(st->parents,node_id);
+    manip_stat_node(mode, node, value);
+
+    return node_id;
+}
+
 
 extern char*
 stats_tree_get_abbr(const char *opt_arg)
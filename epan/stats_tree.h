@@ -219,6 +219,25 @@ WS_DLL_PUBLIC int stats_tree_manip_node(manip_node_mode mode,
 #define avg_stat_node_add_value(st,name,parent_id,with_children,value)  \
     (stats_tree_manip_node(MN_AVERAGE,(st),(name),(parent_id),(with_children),value))
 
+/*
+ * manipulates the value of a node by the id returned when it was created,
+ * avoiding the lookup by name. Only nodes with an id (those created with
+ * stats_tree_create_node() or with children) can be used.
+ */
+WS_DLL_PUBLIC int stats_tree_manip_node_by_id(manip_node_mode mode,
+                                              stats_tree *st,
+                                              int node_id,
+                                              gint value);
+
+#define increase_stat_node_by_id(st,node_id,value)                      \
+    (stats_tree_manip_node_by_id(MN_INCREASE,(st),(node_id),(value)))
+
+#define tick_stat_node_by_id(st,node_id)                                \
+    (stats_tree_manip_node_by_id(MN_INCREASE,(st),(node_id),1))
+
+#define avg_stat_node_add_value_by_id(st,node_id,value)                 \
+    (stats_tree_manip_node_by_id(MN_AVERAGE,(st),(node_id),(value)))
+
 /* Set flags for this node. Node created if it does not yet exist. */
 #define stat_node_set_flags(st,name,parent_id,with_children,flags)      \
     (stats_tree_manip_node(MN_SET_FLAGS,(st),(name),(parent_id),(with_children),flags))
@@ -43,15 +43,6 @@ typedef struct _range_pair {
 	gint ceil;
 } range_pair_t;
 
-typedef struct _burst_bucket burst_bucket;
-struct _burst_bucket {
-	burst_bucket	*next;
-	burst_bucket	*prev;
-	gint			count;
-	double			bucket_no;
-	double			start_time;
-};
-
 struct _stat_node {
 	gchar*			name;
 	int			id;
@@ -66,7 +57,12 @@ struct _stat_node {
 
 	/** fields for burst rate calculation */
 	gint			bcount;
-	burst_bucket	*bh, *bt;
+	/** counts and start times of the buckets in the burst window,
+	 *  in circular arrays indexed by bucket number modulo burst_size */
+	gint			*burst_counts;
+	double			*burst_starts;
+	gint			burst_size;
+	gint64			burst_newest;
 	gint			max_burst;
 	double			burst_time;
 
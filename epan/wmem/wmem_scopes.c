@@ -35,16 +35,133 @@
  * perfect, but it should stop most of the bad behaviour that emem permitted.
  */
 
-/* TODO: Make these thread-local */
 static wmem_allocator_t *packet_scope = NULL;
 static wmem_allocator_t *file_scope   = NULL;
 static wmem_allocator_t *epan_scope   = NULL;
 
+/* Threads other than the one that called wmem_init_scopes() each get their
+ * own packet scope, see wmem_init_thread_scope(). The file and epan scopes
+ * stay shared, so once threads are enabled their allocators serialize
+ * access with a lock. Until then none of this costs anything. */
+static gboolean thread_scopes_enabled = FALSE;
+static GPrivate thread_packet_scope = G_PRIVATE_INIT(NULL);
+
+typedef struct _wmem_locked_allocator_t {
+    wmem_allocator_t *real;
+    GMutex            lock;
+} wmem_locked_allocator_t;
+
+#define LOCKED_ALLOCATOR_LOCK(la) \
+    if (thread_scopes_enabled) g_mutex_lock(&(la)->lock)
+#define LOCKED_ALLOCATOR_UNLOCK(la) \
+    if (thread_scopes_enabled) g_mutex_unlock(&(la)->lock)
+
+static void *
+wmem_locked_alloc(void *private_data, const size_t size)
+{
+    wmem_locked_allocator_t *la = (wmem_locked_allocator_t *)private_data;
+    void *ptr;
+
+    LOCKED_ALLOCATOR_LOCK(la);
+    ptr = la->real->walloc(la->real->private_data, size);
+    LOCKED_ALLOCATOR_UNLOCK(la);
+
+    return ptr;
+}
+
+static void
+wmem_locked_free(void *private_data, void *ptr)
+{
+    wmem_locked_allocator_t *la = (wmem_locked_allocator_t *)private_data;
+
+    LOCKED_ALLOCATOR_LOCK(la);
+    la->real->wfree(la->real->private_data, ptr);
+    LOCKED_ALLOCATOR_UNLOCK(la);
+}
+
+static void *
+wmem_locked_realloc(void *private_data, void *ptr, const size_t size)
+{
+    wmem_locked_allocator_t *la = (wmem_locked_allocator_t *)private_data;
+
+    LOCKED_ALLOCATOR_LOCK(la);
+    ptr = la->real->wrealloc(la->real->private_data, ptr, size);
+    LOCKED_ALLOCATOR_UNLOCK(la);
+
+    return ptr;
+}
+
+static void
+wmem_locked_free_all(void *private_data)
+{
+    wmem_locked_allocator_t *la = (wmem_locked_allocator_t *)private_data;
+
+    LOCKED_ALLOCATOR_LOCK(la);
+    la->real->free_all(la->real->private_data);
+    LOCKED_ALLOCATOR_UNLOCK(la);
+}
+
+static void
+wmem_locked_gc(void *private_data)
+{
+    wmem_locked_allocator_t *la = (wmem_locked_allocator_t *)private_data;
+
+    LOCKED_ALLOCATOR_LOCK(la);
+    la->real->gc(la->real->private_data);
+    LOCKED_ALLOCATOR_UNLOCK(la);
+}
+
+static void
+wmem_locked_cleanup(void *private_data)
+{
+    wmem_locked_allocator_t *la = (wmem_locked_allocator_t *)private_data;
+
+    la->real->cleanup(la->real->private_data);
+    wmem_free(NULL, la->real);
+    g_mutex_clear(&la->lock);
+    wmem_free(NULL, la);
+}
+
+/* Wraps a new allocator of the given type so that it can be shared between
+ * threads once thread_scopes_enabled is set. */
+static wmem_allocator_t *
+wmem_locked_allocator_new(const wmem_allocator_type_t type)
+{
+    wmem_allocator_t        *allocator;
+    wmem_locked_allocator_t *la;
+
+    la = wmem_new(NULL, wmem_locked_allocator_t);
+    la->real = wmem_allocator_new(type);
+    g_mutex_init(&la->lock);
+
+    allocator = wmem_new(NULL, wmem_allocator_t);
+    allocator->walloc       = &wmem_locked_alloc;
+    allocator->wrealloc     = &wmem_locked_realloc;
+    allocator->wfree        = &wmem_locked_free;
+    allocator->free_all     = &wmem_locked_free_all;
+    allocator->gc           = &wmem_locked_gc;
+    allocator->cleanup      = &wmem_locked_cleanup;
+    allocator->callbacks    = NULL;
+    allocator->private_data = (void *)la;
+    allocator->type         = la->real->type;
+    allocator->in_scope     = TRUE;
+
+    return allocator;
+}
+
 /* Packet Scope */
 
 wmem_allocator_t *
 wmem_packet_scope(void)
 {
+    if (G_UNLIKELY(thread_scopes_enabled)) {
+        wmem_allocator_t *thread_scope = (wmem_allocator_t *)g_private_get(&thread_packet_scope);
+
+        if (thread_scope) {
+            return thread_scope;
+        }
+    }
+
     g_assert(packet_scope);
 
     return packet_scope;
@@ -53,21 +170,23 @@ wmem_packet_scope(void)
 void
 wmem_enter_packet_scope(void)
 {
-    g_assert(packet_scope);
+    wmem_allocator_t *scope = wmem_packet_scope();
+
     g_assert(file_scope->in_scope);
-    g_assert(!packet_scope->in_scope);
+    g_assert(!scope->in_scope);
 
-    packet_scope->in_scope = TRUE;
+    scope->in_scope = TRUE;
 }
 
 void
 wmem_leave_packet_scope(void)
 {
-    g_assert(packet_scope);
-    g_assert(packet_scope->in_scope);
+    wmem_allocator_t *scope = wmem_packet_scope();
 
-    wmem_free_all(packet_scope);
-    packet_scope->in_scope = FALSE;
+    g_assert(scope->in_scope);
+
+    wmem_free_all(scope);
+    scope->in_scope = FALSE;
 }
 
 /* File Scope */
@@ -124,8 +243,8 @@ wmem_init_scopes(void)
     g_assert(epan_scope   == NULL);
 
     packet_scope = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK_FAST);
-    file_scope   = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
-    epan_scope   = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
+    file_scope   = wmem_locked_allocator_new(WMEM_ALLOCATOR_BLOCK);
+    epan_scope   = wmem_locked_allocator_new(WMEM_ALLOCATOR_BLOCK);
 
     /* Scopes are initialized to TRUE by default on creation */
     packet_scope->in_scope = FALSE;
@@ -149,6 +268,43 @@ wmem_cleanup_scopes(void)
     packet_scope = NULL;
     file_scope   = NULL;
     epan_scope   = NULL;
+
+    thread_scopes_enabled = FALSE;
+}
+
+/* Threads */
+
+void
+wmem_enable_thread_scopes(void)
+{
+    g_assert(epan_scope);
+
+    thread_scopes_enabled = TRUE;
+}
+
+void
+wmem_init_thread_scope(void)
+{
+    wmem_allocator_t *scope;
+
+    g_assert(thread_scopes_enabled);
+    g_assert(g_private_get(&thread_packet_scope) == NULL);
+
+    scope = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK_FAST);
+    scope->in_scope = FALSE;
+    g_private_set(&thread_packet_scope, scope);
+}
+
+void
+wmem_cleanup_thread_scope(void)
+{
+    wmem_allocator_t *scope = (wmem_allocator_t *)g_private_get(&thread_packet_scope);
+
+    g_assert(scope);
+    g_assert(!scope->in_scope);
+
+    g_private_set(&thread_packet_scope, NULL);
+    wmem_destroy_allocator(scope);
 }
 
 /*
@@ -62,6 +62,27 @@ WS_DLL_LOCAL
 void
 wmem_cleanup_scopes(void);
 
+/* Threads */
+
+/** Allows threads other than the one that initialized the scopes to use
+ * them. Must be called by that thread before any other thread is started.
+ * From then on allocations in the file and epan scopes are serialized. */
+WS_DLL_PUBLIC
+void
+wmem_enable_thread_scopes(void);
+
+/** Gives the calling thread its own packet scope, which wmem_packet_scope()
+ * returns when called from that thread. */
+WS_DLL_PUBLIC
+void
+wmem_init_thread_scope(void);
+
+/** Destroys the calling thread's packet scope. Must be called before the
+ * thread exits, outside of the packet scope. */
+WS_DLL_PUBLIC
+void
+wmem_cleanup_thread_scope(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -194,6 +194,86 @@ wmem_test_allocator_callbacks(void)
     g_assert(cb_called_count == 3);
 }
 
+/* SCOPE TESTS */
+
+#define THREAD_COUNT     4
+#define THREAD_PACKETS   200
+
+static gpointer
+wmem_test_scope_thread(gpointer data)
+{
+    guint8            id = (guint8)GPOINTER_TO_UINT(data);
+    wmem_allocator_t *scope;
+    guint8           *ptrs[32];
+    guint8           *file_ptrs[THREAD_PACKETS];
+    guint             i, j, k;
+
+    wmem_init_thread_scope();
+
+    scope = wmem_packet_scope();
+    g_assert(scope != NULL);
+
+    for (i = 0; i < THREAD_PACKETS; i++) {
+        wmem_enter_packet_scope();
+        g_assert(wmem_packet_scope() == scope);
+
+        for (j = 0; j < G_N_ELEMENTS(ptrs); j++) {
+            ptrs[j] = (guint8 *)wmem_alloc(wmem_packet_scope(), 64 + j);
+            memset(ptrs[j], id, 64 + j);
+        }
+        file_ptrs[i] = (guint8 *)wmem_alloc(wmem_file_scope(), 16);
+        memset(file_ptrs[i], id, 16);
+
+        /* nothing another thread did should have touched our memory */
+        for (j = 0; j < G_N_ELEMENTS(ptrs); j++) {
+            for (k = 0; k < 64 + j; k++) {
+                g_assert(ptrs[j][k] == id);
+            }
+        }
+
+        wmem_leave_packet_scope();
+    }
+
+    for (i = 0; i < THREAD_PACKETS; i++) {
+        for (k = 0; k < 16; k++) {
+            g_assert(file_ptrs[i][k] == id);
+        }
+    }
+
+    wmem_cleanup_thread_scope();
+
+    return NULL;
+}
+
+static void
+wmem_test_scopes_threads(void)
+{
+    GThread          *threads[THREAD_COUNT];
+    wmem_allocator_t *main_scope;
+    guint             i;
+
+    wmem_enter_file_scope();
+
+    main_scope = wmem_packet_scope();
+    wmem_enable_thread_scopes();
+    g_assert(wmem_packet_scope() == main_scope);
+
+    for (i = 0; i < THREAD_COUNT; i++) {
+        threads[i] = g_thread_new("wmem_test", wmem_test_scope_thread,
+                GUINT_TO_POINTER(i + 1));
+    }
+    for (i = 0; i < THREAD_COUNT; i++) {
+        g_thread_join(threads[i]);
+    }
+
+    /* the main thread's packet scope is unaffected */
+    g_assert(wmem_packet_scope() == main_scope);
+    wmem_enter_packet_scope();
+    wmem_leave_packet_scope();
+
+    wmem_leave_file_scope();
+}
+
 static void
 wmem_test_allocator_det(wmem_allocator_t *allocator, wmem_verify_func verify,
         guint len)
@@ -1308,6 +1388,256 @@ wmem_test_tree(void)
     wmem_destroy_allocator(allocator);
 }
 
+static gboolean
+wmem_test_btree_removed_cb(const void *key, void *value, void *user_data _U_)
+{
+    /* only the odd keys are left, each with its key + 1 */
+    g_assert(value != NULL);
+    g_assert(GPOINTER_TO_UINT(key) % 2 == 1);
+    g_assert(GPOINTER_TO_UINT(value) == GPOINTER_TO_UINT(key) + 1);
+
+    cb_called_count++;
+
+    return FALSE;
+}
+
+static void
+wmem_test_btree(void)
+{
+    wmem_allocator_t   *allocator, *extra_allocator;
+    wmem_tree_t        *tree, *rb_tree;
+    guint32             i;
+    int                 seen_values = 0;
+    int                 j;
+    wmem_tree_key_t     keys[3];
+    guint32             key1, key2;
+
+    allocator       = wmem_allocator_new(WMEM_ALLOCATOR_STRICT);
+    extra_allocator = wmem_allocator_new(WMEM_ALLOCATOR_STRICT);
+
+    tree = wmem_tree_new_btree(allocator);
+    g_assert(tree);
+    g_assert(wmem_tree_is_empty(tree));
+    g_assert(wmem_tree_lookup32(tree, 0) == NULL);
+    g_assert(wmem_tree_lookup32_le(tree, G_MAXUINT32) == NULL);
+
+    /* test basic 32-bit key operations, in ascending and descending order */
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        g_assert(wmem_tree_lookup32(tree, i) == NULL);
+        if (i > 0) {
+            g_assert(wmem_tree_lookup32_le(tree, i) == GINT_TO_POINTER(i-1));
+        }
+        wmem_tree_insert32(tree, i, GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32(tree, i) == GINT_TO_POINTER(i));
+        g_assert(!wmem_tree_is_empty(tree));
+    }
+    g_assert(wmem_tree_count(tree) == CONTAINER_ITERS);
+    wmem_free_all(allocator);
+
+    tree = wmem_tree_new_btree(allocator);
+    for (i=CONTAINER_ITERS; i>0; i--) {
+        wmem_tree_insert32(tree, i*2, GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32_le(tree, i*2-1) == NULL);
+        g_assert(wmem_tree_lookup32_le(tree, i*2) == GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32_le(tree, i*2+1) == GINT_TO_POINTER(i));
+    }
+    for (i=1; i<=CONTAINER_ITERS; i++) {
+        g_assert(wmem_tree_lookup32(tree, i*2) == GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32(tree, i*2+1) == NULL);
+    }
+    g_assert(wmem_tree_count(tree) == CONTAINER_ITERS);
+    wmem_free_all(allocator);
+
+    /* compare with a red/black tree using random keys */
+    tree    = wmem_tree_new_btree(allocator);
+    rb_tree = wmem_tree_new(allocator);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        guint32 rand_int = g_test_rand_int();
+
+        wmem_tree_insert32(tree, rand_int, GINT_TO_POINTER(i));
+        wmem_tree_insert32(rb_tree, rand_int, GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32(tree, rand_int) == GINT_TO_POINTER(i));
+    }
+    g_assert(wmem_tree_count(tree) == wmem_tree_count(rb_tree));
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        guint32 rand_int = g_test_rand_int();
+
+        g_assert(wmem_tree_lookup32(tree, rand_int) ==
+                wmem_tree_lookup32(rb_tree, rand_int));
+        g_assert(wmem_tree_lookup32_le(tree, rand_int) ==
+                wmem_tree_lookup32_le(rb_tree, rand_int));
+    }
+    wmem_free_all(allocator);
+
+    /* test remove, which counts and walks the same in a red/black tree */
+    for (j=0; j<2; j++) {
+        tree = j ? wmem_tree_new(allocator) : wmem_tree_new_btree(allocator);
+        for (i=0; i<CONTAINER_ITERS; i++) {
+            wmem_tree_insert32(tree, i, GINT_TO_POINTER(i+1));
+        }
+        for (i=0; i<CONTAINER_ITERS; i+=2) {
+            g_assert(wmem_tree_remove32(tree, i) == GINT_TO_POINTER(i+1));
+            g_assert(wmem_tree_lookup32(tree, i) == NULL);
+            g_assert(wmem_tree_lookup32(tree, i+1) == GINT_TO_POINTER(i+2));
+        }
+        g_assert(wmem_tree_count(tree) == CONTAINER_ITERS / 2);
+        cb_called_count = 0;
+        wmem_tree_foreach(tree, wmem_test_btree_removed_cb, NULL);
+        g_assert(cb_called_count == CONTAINER_ITERS / 2);
+        /* a removed key can be added back */
+        wmem_tree_insert32(tree, 0, GINT_TO_POINTER(1));
+        g_assert(wmem_tree_count(tree) == CONTAINER_ITERS / 2 + 1);
+        wmem_tree_remove32(tree, 0);
+        for (i=0; i<CONTAINER_ITERS; i+=2) {
+            wmem_tree_remove32(tree, i+1);
+        }
+        g_assert(wmem_tree_count(tree) == 0);
+        wmem_free_all(allocator);
+    }
+
+    /* test auto-reset functionality */
+    tree = wmem_tree_new_btree_autoreset(allocator, extra_allocator);
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        g_assert(wmem_tree_lookup32(tree, i) == NULL);
+        wmem_tree_insert32(tree, i, GINT_TO_POINTER(i));
+        g_assert(wmem_tree_lookup32(tree, i) == GINT_TO_POINTER(i));
+    }
+    g_assert(wmem_tree_count(tree) == CONTAINER_ITERS);
+    wmem_free_all(extra_allocator);
+    g_assert(wmem_tree_count(tree) == 0);
+    g_assert(wmem_tree_is_empty(tree));
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        g_assert(wmem_tree_lookup32(tree, i) == NULL);
+        g_assert(wmem_tree_lookup32_le(tree, i) == NULL);
+    }
+    wmem_free_all(allocator);
+
+    /* test array key functionality */
+    tree = wmem_tree_new_btree(allocator);
+    keys[0].length = 1;
+    keys[0].key    = &key1;
+    keys[1].length = 1;
+    keys[1].key    = &key2;
+    keys[2].length = 0;
+    for (key1=0; key1<100; key1++) {
+        for (key2=0; key2<100; key2++) {
+            wmem_tree_insert32_array(tree, keys, GINT_TO_POINTER(key1*100+key2+1));
+        }
+    }
+    g_assert(wmem_tree_count(tree) == 100*100);
+    for (key1=0; key1<100; key1++) {
+        for (key2=0; key2<100; key2++) {
+            g_assert(wmem_tree_lookup32_array(tree, keys) ==
+                    GINT_TO_POINTER(key1*100+key2+1));
+        }
+        key2 = 1000;
+        g_assert(wmem_tree_lookup32_array_le(tree, keys) ==
+                GINT_TO_POINTER(key1*100+100));
+    }
+    wmem_free_all(allocator);
+
+    /* test for-each functionality */
+    tree = wmem_tree_new_btree(allocator);
+    expected_user_data = GINT_TO_POINTER(g_test_rand_int());
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        gint tmp;
+        do {
+            tmp = g_test_rand_int();
+        } while (wmem_tree_lookup32(tree, tmp));
+        value_seen[i] = FALSE;
+        wmem_tree_insert32(tree, tmp, GINT_TO_POINTER(i));
+    }
+
+    cb_called_count    = 0;
+    cb_continue_count  = CONTAINER_ITERS;
+    wmem_tree_foreach(tree, wmem_test_foreach_cb, expected_user_data);
+    g_assert(cb_called_count   == CONTAINER_ITERS);
+    g_assert(cb_continue_count == 0);
+
+    for (i=0; i<CONTAINER_ITERS; i++) {
+        g_assert(value_seen[i]);
+        value_seen[i] = FALSE;
+    }
+
+    cb_called_count    = 0;
+    cb_continue_count  = 10;
+    wmem_tree_foreach(tree, wmem_test_foreach_cb, expected_user_data);
+    g_assert(cb_called_count   == 10);
+    g_assert(cb_continue_count == 0);
+
+    for (j=0; j<CONTAINER_ITERS; j++) {
+        if (value_seen[j]) {
+            seen_values++;
+        }
+    }
+    g_assert(seen_values == 10);
+
+    wmem_destroy_allocator(extra_allocator);
+    wmem_destroy_allocator(allocator);
+}
+
+/* NOTE: You have to run "wmem_test --verbose" to see results. */
+static void
+wmem_test_treeperf(void)
+{
+#define TREE_PERF_KEYS (1000 * 1000)
+    wmem_allocator_t   *allocator;
+    wmem_tree_t        *tree;
+    guint32            *rand_keys = g_new(guint32, TREE_PERF_KEYS);
+    guint32             i;
+    int                 pass;
+    double              start_utime, start_stime, end_utime, end_stime, utime_ms, stime_ms;
+
+    allocator = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
+
+    for (i = 0; i < TREE_PERF_KEYS; i++) {
+        rand_keys[i] = g_test_rand_int();
+    }
+
+    for (pass = 0; pass < 2; pass++) {
+        const char *name = pass ? "B+tree" : "red/black tree";
+
+        tree = pass ? wmem_tree_new_btree(allocator) : wmem_tree_new(allocator);
+        RESOURCE_USAGE_START;
+        for (i = 0; i < TREE_PERF_KEYS; i++) {
+            wmem_tree_insert32(tree, i, GUINT_TO_POINTER(i));
+        }
+        RESOURCE_USAGE_END;
+        g_test_minimized_result(utime_ms + stime_ms,
+            "%s insert32 ascending: u %.3f ms s %.3f ms", name, utime_ms, stime_ms);
+
+        RESOURCE_USAGE_START;
+        for (i = 0; i < TREE_PERF_KEYS; i++) {
+            wmem_tree_lookup32_le(tree, rand_keys[i] % TREE_PERF_KEYS);
+        }
+        RESOURCE_USAGE_END;
+        g_test_minimized_result(utime_ms + stime_ms,
+            "%s lookup32_le: u %.3f ms s %.3f ms", name, utime_ms, stime_ms);
+        wmem_free_all(allocator);
+
+        tree = pass ? wmem_tree_new_btree(allocator) : wmem_tree_new(allocator);
+        RESOURCE_USAGE_START;
+        for (i = 0; i < TREE_PERF_KEYS; i++) {
+            wmem_tree_insert32(tree, rand_keys[i], GUINT_TO_POINTER(i));
+        }
+        RESOURCE_USAGE_END;
+        g_test_minimized_result(utime_ms + stime_ms,
+            "%s insert32 random: u %.3f ms s %.3f ms", name, utime_ms, stime_ms);
+
+        RESOURCE_USAGE_START;
+        for (i = 0; i < TREE_PERF_KEYS; i++) {
+            wmem_tree_lookup32(tree, rand_keys[i]);
+        }
+        RESOURCE_USAGE_END;
+        g_test_minimized_result(utime_ms + stime_ms,
+            "%s lookup32 random: u %.3f ms s %.3f ms", name, utime_ms, stime_ms);
+        wmem_free_all(allocator);
+    }
+
+    wmem_destroy_allocator(allocator);
+    g_free(rand_keys);
+}
+
 
 /* to be used as userdata in the callback wmem_test_itree_check_overlap_cb*/
 typedef struct wmem_test_itree_user_data {
@@ -1426,11 +1756,14 @@ main(int argc, char **argv)
     g_test_add_func("/wmem/allocator/strict",    wmem_test_allocator_strict);
     g_test_add_func("/wmem/allocator/callbacks", wmem_test_allocator_callbacks);
 
+    g_test_add_func("/wmem/scopes/threads", wmem_test_scopes_threads);
+
     g_test_add_func("/wmem/utils/misc",    wmem_test_miscutls);
     g_test_add_func("/wmem/utils/strings", wmem_test_strutls);
 
     if (!g_test_perf ()) {
         g_test_add_func("/wmem/utils/stringperf", wmem_test_stringperf);
+        g_test_add_func("/wmem/datastruct/treeperf", wmem_test_treeperf);
     }
 
     g_test_add_func("/wmem/datastruct/array",  wmem_test_array);
@@ -1440,6 +1773,7 @@ main(int argc, char **argv)
     g_test_add_func("/wmem/datastruct/stack",  wmem_test_stack);
     g_test_add_func("/wmem/datastruct/strbuf", wmem_test_strbuf);
     g_test_add_func("/wmem/datastruct/tree",   wmem_test_tree);
+    g_test_add_func("/wmem/datastruct/btree",  wmem_test_btree);
     g_test_add_func("/wmem/datastruct/itree",  wmem_test_itree);
 
     ret = g_test_run();
@@ -44,10 +44,30 @@ typedef struct _wmem_tree_node_t wmem_tree_node_t;
 
 typedef struct _wmem_itree_node_t wmem_itree_node_t;
 
+/* Maximum number of keys in a node of a tree created by wmem_tree_new_btree */
+#define WMEM_BTREE_MAX_KEYS 15
+
+/* A B+tree node. Values are only stored in the leaves; the keys of an
+ * internal node separate its children, ptrs[i] holding the keys below
+ * keys[i] and ptrs[i+1] those from keys[i] on. Every key of a node is
+ * also the smallest key stored under the child to its right. */
+struct _wmem_btree_node_t {
+    guint16  count;          /* number of keys */
+    guint16  is_leaf;
+    guint32  subtree_mask;   /* leaves: bit i set if ptrs[i] is a subtree */
+    guint32  removed_mask;   /* leaves: bit i set if keys[i] has been removed */
+    guint32  keys[WMEM_BTREE_MAX_KEYS];
+    void    *ptrs[WMEM_BTREE_MAX_KEYS + 1];
+};
+
+typedef struct _wmem_btree_node_t wmem_btree_node_t;
+
 struct _wmem_tree_t {
     wmem_allocator_t *master;
     wmem_allocator_t *allocator;
     wmem_tree_node_t *root;
+    wmem_btree_node_t *btree_root; /* used instead of root if is_btree */
+    gboolean          is_btree;
     guint             master_cb_id;
     guint             slave_cb_id;
 
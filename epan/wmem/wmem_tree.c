@@ -206,6 +206,17 @@ wmem_tree_new(wmem_allocator_t *allocator)
     return tree;
 }
 
+wmem_tree_t *
+wmem_tree_new_btree(wmem_allocator_t *allocator)
+{
+    wmem_tree_t *tree;
+
+    tree = wmem_tree_new(allocator);
+    tree->is_btree = TRUE;
+
+    return tree;
+}
+
 static gboolean
 wmem_tree_reset_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event,
         void *user_data)
@@ -213,6 +224,7 @@ wmem_tree_reset_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event,
     wmem_tree_t *tree = (wmem_tree_t *)user_data;
 
     tree->root = NULL;
+    tree->btree_root = NULL;
 
     if (event == WMEM_CB_DESTROY_EVENT) {
         wmem_unregister_callback(tree->master, tree->master_cb_id);
@@ -250,6 +262,43 @@ wmem_tree_new_autoreset(wmem_allocator_t *master, wmem_allocator_t *slave)
     return tree;
 }
 
+wmem_tree_t *
+wmem_tree_new_btree_autoreset(wmem_allocator_t *master, wmem_allocator_t *slave)
+{
+    wmem_tree_t *tree;
+
+    tree = wmem_tree_new_autoreset(master, slave);
+    tree->is_btree = TRUE;
+
+    return tree;
+}
+
+static void
+free_btree_node(wmem_allocator_t *allocator, wmem_btree_node_t *node, gboolean free_keys, gboolean free_values)
+{
+    guint i;
+
+    if (node == NULL) {
+        return;
+    }
+
+    if (!node->is_leaf) {
+        for (i = 0; i <= node->count; i++) {
+            free_btree_node(allocator, (wmem_btree_node_t *)node->ptrs[i], free_keys, free_values);
+        }
+    } else {
+        for (i = 0; i < node->count; i++) {
+            if (node->subtree_mask & (1U << i)) {
+                wmem_tree_destroy((wmem_tree_t *)node->ptrs[i], free_keys, free_values);
+            } else if (free_values) {
+                wmem_free(allocator, node->ptrs[i]);
+            }
+        }
+    }
+
+    wmem_free(allocator, node);
+}
+
 static void
 free_tree_node(wmem_allocator_t *allocator, wmem_tree_node_t* node, gboolean free_keys, gboolean free_values)
 {
@@ -283,7 +332,12 @@ free_tree_node(wmem_allocator_t *allocator, wmem_tree_node_t* node, gboolean fre
 void
 wmem_tree_destroy(wmem_tree_t *tree, gboolean free_keys, gboolean free_values)
 {
-    free_tree_node(tree->allocator, tree->root, free_keys, free_values);
+    if (tree->is_btree) {
+        /* The keys are stored in the nodes, there's nothing to free */
+        free_btree_node(tree->allocator, tree->btree_root, FALSE, free_values);
+    } else {
+        free_tree_node(tree->allocator, tree->root, free_keys, free_values);
+    }
     if (tree->master) {
         wmem_unregister_callback(tree->master, tree->master_cb_id);
     }
@@ -296,7 +350,7 @@ wmem_tree_destroy(wmem_tree_t *tree, gboolean free_keys, gboolean free_values)
 gboolean
 wmem_tree_is_empty(wmem_tree_t *tree)
 {
-    return tree->root == NULL;
+    return tree->root == NULL && tree->btree_root == NULL;
 }
 
 static gboolean
@@ -371,6 +425,7 @@ lookup_or_insert32_node(wmem_tree_t *tree, guint32 key,
         if (key == GPOINTER_TO_UINT(node->key)) {
             if (replace) {
                 node->data = CREATE_DATA(func, data);
+                node->is_removed = node->data ? FALSE : TRUE;
             }
             return node;
         }
@@ -407,11 +462,224 @@ lookup_or_insert32_node(wmem_tree_t *tree, guint32 key,
 }
 
 
+/* Returns the number of keys in the node that are <= key. The keys of
+ * a node fit in one or two cache lines, so a linear scan is as fast as
+ * a binary search here. */
+static inline guint
+btree_upper_bound(const wmem_btree_node_t *node, guint32 key)
+{
+    guint i;
+
+    for (i = 0; i < node->count && node->keys[i] <= key; i++)
+        ;
+
+    return i;
+}
+
+static wmem_btree_node_t *
+btree_new_node(wmem_allocator_t *allocator, gboolean is_leaf)
+{
+    wmem_btree_node_t *node;
+
+    node = wmem_new(allocator, wmem_btree_node_t);
+    node->count = 0;
+    node->is_leaf = is_leaf;
+    node->subtree_mask = 0;
+    node->removed_mask = 0;
+
+    return node;
+}
+
+static const wmem_btree_node_t *
+btree_find_leaf(const wmem_tree_t *tree, guint32 key)
+{
+    const wmem_btree_node_t *node = tree->btree_root;
+
+    if (node == NULL) {
+        return NULL;
+    }
+
+    while (!node->is_leaf) {
+        node = (const wmem_btree_node_t *)node->ptrs[btree_upper_bound(node, key)];
+    }
+
+    return node;
+}
+
+static void
+btree_leaf_insert_at(wmem_btree_node_t *leaf, guint i, guint32 key, void *value, gboolean is_subtree)
+{
+    guint32 low_mask = (1U << i) - 1;
+
+    memmove(&leaf->keys[i + 1], &leaf->keys[i], (leaf->count - i) * sizeof leaf->keys[0]);
+    memmove(&leaf->ptrs[i + 1], &leaf->ptrs[i], (leaf->count - i) * sizeof leaf->ptrs[0]);
+    leaf->keys[i] = key;
+    leaf->ptrs[i] = value;
+    leaf->subtree_mask = (leaf->subtree_mask & low_mask) |
+                         ((leaf->subtree_mask & ~low_mask) << 1) |
+                         (is_subtree ? (1U << i) : 0);
+    leaf->removed_mask = (leaf->removed_mask & low_mask) |
+                         ((leaf->removed_mask & ~low_mask) << 1);
+    leaf->count++;
+}
+
+/* Moves the upper half of a full leaf to a new leaf and returns it. */
+static wmem_btree_node_t *
+btree_split_leaf(wmem_allocator_t *allocator, wmem_btree_node_t *leaf)
+{
+    const guint keep = (WMEM_BTREE_MAX_KEYS + 1) / 2;
+    wmem_btree_node_t *right;
+
+    right = btree_new_node(allocator, TRUE);
+    right->count = leaf->count - keep;
+    memcpy(right->keys, &leaf->keys[keep], right->count * sizeof leaf->keys[0]);
+    memcpy(right->ptrs, &leaf->ptrs[keep], right->count * sizeof leaf->ptrs[0]);
+    right->subtree_mask = leaf->subtree_mask >> keep;
+    right->removed_mask = leaf->removed_mask >> keep;
+
+    leaf->count = keep;
+    leaf->subtree_mask &= (1U << keep) - 1;
+    leaf->removed_mask &= (1U << keep) - 1;
+
+    return right;
+}
+
+/* Adds child, whose smallest key is sep, to the right of ptrs[i]. If the
+ * node is full it is split, and the new right node is returned with the
+ * key separating it from the node in *split_key. */
+static wmem_btree_node_t *
+btree_internal_insert_at(wmem_allocator_t *allocator, wmem_btree_node_t *node, guint i,
+        guint32 sep, wmem_btree_node_t *child, guint32 *split_key)
+{
+    guint32 keys[WMEM_BTREE_MAX_KEYS + 1];
+    void *ptrs[WMEM_BTREE_MAX_KEYS + 2];
+    const guint mid = (WMEM_BTREE_MAX_KEYS + 1) / 2;
+    wmem_btree_node_t *right;
+
+    if (node->count < WMEM_BTREE_MAX_KEYS) {
+        memmove(&node->keys[i + 1], &node->keys[i], (node->count - i) * sizeof node->keys[0]);
+        memmove(&node->ptrs[i + 2], &node->ptrs[i + 1], (node->count - i) * sizeof node->ptrs[0]);
+        node->keys[i] = sep;
+        node->ptrs[i + 1] = child;
+        node->count++;
+        return NULL;
+    }
+
+    memcpy(keys, node->keys, i * sizeof keys[0]);
+    keys[i] = sep;
+    memcpy(&keys[i + 1], &node->keys[i], (WMEM_BTREE_MAX_KEYS - i) * sizeof keys[0]);
+    memcpy(ptrs, node->ptrs, (i + 1) * sizeof ptrs[0]);
+    ptrs[i + 1] = child;
+    memcpy(&ptrs[i + 2], &node->ptrs[i + 1], (WMEM_BTREE_MAX_KEYS - i) * sizeof ptrs[0]);
+
+    /* keys[mid] moves up, the keys after it go to the new node */
+    right = btree_new_node(allocator, FALSE);
+    right->count = WMEM_BTREE_MAX_KEYS - mid;
+    memcpy(right->keys, &keys[mid + 1], right->count * sizeof keys[0]);
+    memcpy(right->ptrs, &ptrs[mid + 1], (right->count + 1) * sizeof ptrs[0]);
+
+    node->count = mid;
+    memcpy(node->keys, keys, mid * sizeof keys[0]);
+    memcpy(node->ptrs, ptrs, (mid + 1) * sizeof ptrs[0]);
+
+    *split_key = keys[mid];
+    return right;
+}
+
+/* Inserts into the subtree under node. If node had to be split, returns
+ * the new node to its right, with the smallest key of that in *split_key. */
+static wmem_btree_node_t *
+btree_insert(wmem_tree_t *tree, wmem_btree_node_t *node, guint32 key,
+        void*(*func)(void*), void* data, gboolean is_subtree, gboolean replace,
+        void **value, guint32 *split_key)
+{
+    guint i = btree_upper_bound(node, key);
+    wmem_btree_node_t *right, *target, *new_child;
+    guint32 child_split_key;
+
+    if (!node->is_leaf) {
+        new_child = btree_insert(tree, (wmem_btree_node_t *)node->ptrs[i], key,
+                func, data, is_subtree, replace, value, &child_split_key);
+        if (new_child == NULL) {
+            return NULL;
+        }
+        return btree_internal_insert_at(tree->allocator, node, i, child_split_key, new_child, split_key);
+    }
+
+    /* this key already exists, so just return the data pointer */
+    if (i > 0 && node->keys[i - 1] == key) {
+        if (replace) {
+            node->ptrs[i - 1] = CREATE_DATA(func, data);
+            /* the value is whatever the caller says it is now */
+            node->subtree_mask &= ~(1U << (i - 1));
+            if (is_subtree) {
+                node->subtree_mask |= 1U << (i - 1);
+            }
+            /* like the red/black tree, replacing with NULL removes */
+            node->removed_mask &= ~(1U << (i - 1));
+            if (node->ptrs[i - 1] == NULL) {
+                node->removed_mask |= 1U << (i - 1);
+            }
+        }
+        *value = node->ptrs[i - 1];
+        return NULL;
+    }
+
+    right = NULL;
+    target = node;
+    if (node->count == WMEM_BTREE_MAX_KEYS) {
+        right = btree_split_leaf(tree->allocator, node);
+        *split_key = right->keys[0];
+        if (key > *split_key) {
+            target = right;
+            i -= node->count;
+        }
+    }
+
+    btree_leaf_insert_at(target, i, key, CREATE_DATA(func, data), is_subtree);
+    *value = target->ptrs[i];
+
+    return right;
+}
+
+static void *
+btree_lookup_or_insert32(wmem_tree_t *tree, guint32 key,
+        void*(*func)(void*), void* data, gboolean is_subtree, gboolean replace)
+{
+    wmem_btree_node_t *right, *new_root;
+    guint32 split_key;
+    void *value;
+
+    if (tree->btree_root == NULL) {
+        tree->btree_root = btree_new_node(tree->allocator, TRUE);
+    }
+
+    right = btree_insert(tree, tree->btree_root, key, func, data, is_subtree,
+            replace, &value, &split_key);
+    if (right != NULL) {
+        /* the root was split, so the tree grows a level */
+        new_root = btree_new_node(tree->allocator, FALSE);
+        new_root->count = 1;
+        new_root->keys[0] = split_key;
+        new_root->ptrs[0] = tree->btree_root;
+        new_root->ptrs[1] = right;
+        tree->btree_root = new_root;
+    }
+
+    return value;
+}
+
 static void *
 lookup_or_insert32(wmem_tree_t *tree, guint32 key,
         void*(*func)(void*), void* data, gboolean is_subtree, gboolean replace)
 {
-    wmem_tree_node_t *node = lookup_or_insert32_node(tree, key, func, data, is_subtree, replace);
+    wmem_tree_node_t *node;
+
+    if (tree->is_btree) {
+        return btree_lookup_or_insert32(tree, key, func, data, is_subtree, replace);
+    }
+
+    node = lookup_or_insert32_node(tree, key, func, data, is_subtree, replace);
     return node->data;
 }
 
@@ -424,6 +692,9 @@ wmem_tree_lookup(wmem_tree_t *tree, const void *key, compare_func cmp)
         return NULL;
     }
 
+    /* B+trees only take 32-bit keys */
+    g_assert(!tree->is_btree);
+
     node = tree->root;
 
     while (node) {
@@ -448,6 +719,9 @@ wmem_tree_insert(wmem_tree_t *tree, const void *key, void *data, compare_func cm
     wmem_tree_node_t *node = tree->root;
     wmem_tree_node_t *new_node = NULL;
 
+    /* B+trees only take 32-bit keys */
+    g_assert(!tree->is_btree);
+
     /* is this the first node ?*/
     if (!node) {
         tree->root = create_node(tree->allocator, node, key,
@@ -505,6 +779,17 @@ wmem_tree_lookup32(wmem_tree_t *tree, guint32 key)
 {
     wmem_tree_node_t *node = tree->root;
 
+    if (tree->is_btree) {
+        const wmem_btree_node_t *leaf = btree_find_leaf(tree, key);
+        guint i;
+
+        if (leaf == NULL) {
+            return NULL;
+        }
+        i = btree_upper_bound(leaf, key);
+        return (i > 0 && leaf->keys[i - 1] == key) ? leaf->ptrs[i - 1] : NULL;
+    }
+
     while (node) {
         if (key == GPOINTER_TO_UINT(node->key)) {
             return node->data;
@@ -525,6 +810,20 @@ wmem_tree_lookup32_le(wmem_tree_t *tree, guint32 key)
 {
     wmem_tree_node_t *node = tree->root;
 
+    if (tree->is_btree) {
+        const wmem_btree_node_t *leaf = btree_find_leaf(tree, key);
+        guint i;
+
+        if (leaf == NULL) {
+            return NULL;
+        }
+        /* If the search went right of any key on the way down, the leaf
+         * holds that key, so it has one <= key. Otherwise this is the
+         * leftmost leaf and there may be none. */
+        i = btree_upper_bound(leaf, key);
+        return (i > 0) ? leaf->ptrs[i - 1] : NULL;
+    }
+
     while (node) {
         if (key == GPOINTER_TO_UINT(node->key)) {
             return node->data;
@@ -638,7 +937,12 @@ wmem_tree_remove_string(wmem_tree_t* tree, const gchar* k, guint32 flags)
 static void *
 create_sub_tree(void* d)
 {
-    return wmem_tree_new(((wmem_tree_t *)d)->allocator);
+    wmem_tree_t *tree = (wmem_tree_t *)d;
+
+    if (tree->is_btree) {
+        return wmem_tree_new_btree(tree->allocator);
+    }
+    return wmem_tree_new(tree->allocator);
 }
 
 void
@@ -750,10 +1054,52 @@ wmem_tree_foreach_nodes(wmem_tree_node_t* node, wmem_foreach_func callback,
     return FALSE;
 }
 
+static gboolean
+wmem_btree_foreach_nodes(const wmem_btree_node_t *node, wmem_foreach_func callback,
+        void *user_data)
+{
+    guint i;
+
+    if (!node->is_leaf) {
+        for (i = 0; i <= node->count; i++) {
+            if (wmem_btree_foreach_nodes((const wmem_btree_node_t *)node->ptrs[i], callback, user_data)) {
+                return TRUE;
+            }
+        }
+        return FALSE;
+    }
+
+    for (i = 0; i < node->count; i++) {
+        gboolean stop_traverse;
+
+        if (node->subtree_mask & (1U << i)) {
+            stop_traverse = wmem_tree_foreach((wmem_tree_t *)node->ptrs[i],
+                    callback, user_data);
+        } else if (node->removed_mask & (1U << i)) {
+            /* removed by wmem_tree_remove32() */
+            continue;
+        } else {
+            stop_traverse = callback(GUINT_TO_POINTER(node->keys[i]), node->ptrs[i], user_data);
+        }
+
+        if (stop_traverse) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
 gboolean
 wmem_tree_foreach(wmem_tree_t* tree, wmem_foreach_func callback,
         void *user_data)
 {
+    if (tree->is_btree) {
+        if (!tree->btree_root)
+            return FALSE;
+        return wmem_btree_foreach_nodes(tree->btree_root, callback, user_data);
+    }
+
     if(!tree->root)
         return FALSE;
 
@@ -806,6 +1152,47 @@ wmem_tree_print_nodes(const char *prefix, wmem_tree_node_t *node, guint32 level,
 }
 
 
+static void
+wmem_btree_print_nodes(const wmem_btree_node_t *node, guint32 level,
+    wmem_printer_func key_printer, wmem_printer_func data_printer)
+{
+    guint i;
+
+    wmem_print_indent(level);
+
+    ws_debug_printf("%s:%p keys:%u\n", node->is_leaf ? "LEAF" : "NODE",
+            (const void *)node, node->count);
+
+    for (i = 0; i < node->count; i++) {
+        if (!node->is_leaf) {
+            wmem_btree_print_nodes((const wmem_btree_node_t *)node->ptrs[i], level+1, key_printer, data_printer);
+            wmem_print_indent(level);
+            ws_debug_printf("SEP key:%u\n", node->keys[i]);
+            continue;
+        }
+
+        wmem_print_indent(level+1);
+        ws_debug_printf("key:%u %s:%p\n", node->keys[i],
+                (node->subtree_mask & (1U << i)) ? "tree" : "data", node->ptrs[i]);
+        if (key_printer) {
+            wmem_print_indent(level+1);
+            key_printer(GUINT_TO_POINTER(node->keys[i]));
+            ws_debug_printf("\n");
+        }
+        if (node->subtree_mask & (1U << i)) {
+            wmem_print_subtree((wmem_tree_t *)node->ptrs[i], level+2, key_printer, data_printer);
+        } else if (data_printer) {
+            wmem_print_indent(level+1);
+            data_printer(node->ptrs[i]);
+            ws_debug_printf("\n");
+        }
+    }
+
+    if (!node->is_leaf) {
+        wmem_btree_print_nodes((const wmem_btree_node_t *)node->ptrs[node->count], level+1, key_printer, data_printer);
+    }
+}
+
 static void
 wmem_print_subtree(wmem_tree_t *tree, guint32 level, wmem_printer_func key_printer, wmem_printer_func data_printer)
 {
@@ -814,6 +1201,14 @@ wmem_print_subtree(wmem_tree_t *tree, guint32 level, wmem_printer_func key_print
 
     wmem_print_indent(level);
 
+    if (tree->is_btree) {
+        ws_debug_printf("WMEM B+tree:%p root:%p\n", (void *)tree, (void *)tree->btree_root);
+        if (tree->btree_root) {
+            wmem_btree_print_nodes(tree->btree_root, level, key_printer, data_printer);
+        }
+        return;
+    }
+
     ws_debug_printf("WMEM tree:%p root:%p\n", (void *)tree, (void *)tree->root);
     if (tree->root) {
         wmem_tree_print_nodes("Root-", tree->root, level, key_printer, data_printer);
@@ -2142,12 +2142,6 @@ dissect_wimaxasncp(
 
     offset = 0;
 
-    /* Register protocol fields, etc if haven't done yet. */
-    if (hf_wimaxasncp_version == -1)
-    {
-        proto_registrar_get_byname("wimaxasncp.version");
-    }
-
     if (tree)
     {
         packet_item = proto_tree_add_item(
@@ -3416,7 +3410,7 @@ proto_register_wimaxasncp(void)
         wimaxasncp_nwg_versions,
         FALSE);
 
-    proto_register_prefix("wimaxasncp", register_wimaxasncp_fields);
+    proto_register_fields_deferred(proto_wimaxasncp, register_wimaxasncp_fields);
 }
 
 /* ========================================================================= */
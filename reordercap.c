@@ -25,6 +25,7 @@
 #include "wsutil/wsgetopt.h"
 #endif
 
+#include <wsutil/clopts_common.h>
 #include <wsutil/cmdarg_err.h>
 #include <wsutil/crash_info.h>
 #include <wsutil/filesystem.h>
@@ -45,6 +46,9 @@
 #define OPEN_ERROR 2
 #define OUTPUT_FILE_ERROR 1
 
+/* Default upper bound on frame data held in memory while sorting */
+#define DEFAULT_SORT_MEMORY_MB 512
+
 /* Show command-line usage */
 static void
 print_usage(FILE *output)
@@ -54,17 +58,51 @@ print_usage(FILE *output)
     fprintf(output, "\n");
     fprintf(output, "Options:\n");
     fprintf(output, "  -n        don't write to output file if the input file is ordered.\n");
+    fprintf(output, "  -m <MB>   memory to use for sorting before spilling sorted runs\n");
+    fprintf(output, "            to temporary files (default %u).\n", DEFAULT_SORT_MEMORY_MB);
     fprintf(output, "  -h        display this help and exit.\n");
 }
 
-/* Remember where this frame was in the file */
+/* A frame held in memory until it is written to the output or to a run */
 typedef struct FrameRecord_t {
-    gint64       offset;
+    gint64       sort_key;      /* frame time as a packed time stamp */
     guint        num;
-
-    nstime_t     frame_time;
+    guint        run;           /* sorted run the frame is assigned to */
+    wtap_rec     rec;
+    guint8      *data;
 } FrameRecord_t;
 
+/*
+ * Frames are sorted by replacement selection: they are kept in a heap
+ * ordered by (run, time stamp) and, once the memory budget is exhausted,
+ * the earliest frame is written to a sorted run in a temporary file.  A
+ * frame that is older than the last one written to the current run is
+ * deferred to the next run.  Input whose disorder is confined to windows
+ * smaller than the budget therefore produces a single run, and larger
+ * captures produce runs about twice the budget that are merged
+ * sequentially at the end.
+ */
+typedef struct {
+    GPtrArray   *heap;
+    gsize        mem_used;
+    gsize        mem_limit;
+    guint        run;           /* run currently being written */
+    gint64       last_key;      /* key of the last frame written to it */
+    wtap_dumper *run_pdh;
+    GPtrArray   *run_files;     /* names of the temporary run files */
+} FrameSorter_t;
+
+/* A sorted run being read back during the final merge: a temporary file,
+   the in-order frames at the start of the input file, or the frames still
+   in the sort heap */
+typedef struct {
+    wtap        *wth;           /* NULL for the sort heap */
+    const char  *filename;
+    guint        left;          /* frames left to read from wth */
+    gint64       sort_key;
+    gboolean     done;
+} SortedRun_t;
+
 
 /**************************************************/
 /* Debugging only                                 */
@@ -80,59 +118,376 @@ typedef struct FrameRecord_t {
 /**************************************************/
 
 
+static gint64
+rec_sort_key(const wtap_rec *rec)
+{
+    if (rec->presence_flags & WTAP_HAS_TS) {
+        return nstime_to_packed(&rec->ts);
+    }
+    return NSTIME_PACKED_UNSET;
+}
+
+static guint32
+rec_data_len(const wtap_rec *rec)
+{
+    switch (rec->rec_type) {
+        case REC_TYPE_PACKET:
+            return rec->rec_header.packet_header.caplen;
+        case REC_TYPE_FT_SPECIFIC_EVENT:
+        case REC_TYPE_FT_SPECIFIC_REPORT:
+            return rec->rec_header.ft_specific_header.record_len;
+        case REC_TYPE_SYSCALL:
+            return rec->rec_header.syscall_header.event_filelen;
+    }
+    return 0;
+}
+
+static FrameRecord_t *
+frame_new(const wtap_rec *rec, const guint8 *data, guint num, gsize *size)
+{
+    FrameRecord_t *frame = g_slice_new(FrameRecord_t);
+    guint32 data_len = rec_data_len(rec);
+
+    frame->sort_key = rec_sort_key(rec);
+    frame->num = num;
+    frame->run = 0;
+    frame->rec = *rec;
+    /* The options buffer belongs to the reader and is only used there. */
+    memset(&frame->rec.options_buf, 0, sizeof frame->rec.options_buf);
+    frame->rec.opt_comment = g_strdup(rec->opt_comment);
+    frame->data = (guint8 *)g_memdup(data, data_len);
+
+    *size = sizeof(FrameRecord_t) + data_len;
+    return frame;
+}
+
 static void
-frame_write(FrameRecord_t *frame, wtap *wth, wtap_dumper *pdh,
-            wtap_rec *rec, Buffer *buf, const char *infile,
-            const char *outfile)
+frame_free(FrameRecord_t *frame)
+{
+    g_free(frame->rec.opt_comment);
+    g_free(frame->data);
+    g_slice_free(FrameRecord_t, frame);
+}
+
+/* Comparing frames in the sort heap.
+   TRUE if frame1 must be written before frame2 */
+static gboolean
+frame_before(const FrameRecord_t *frame1, const FrameRecord_t *frame2)
+{
+    if (frame1->run != frame2->run)
+        return frame1->run < frame2->run;
+    if (frame1->sort_key != frame2->sort_key)
+        return frame1->sort_key < frame2->sort_key;
+    return frame1->num < frame2->num;
+}
+
+static void
+heap_push(GPtrArray *heap, FrameRecord_t *frame)
+{
+    guint i = heap->len;
+
+    g_ptr_array_add(heap, frame);
+    while (i > 0) {
+        guint parent = (i - 1) / 2;
+        if (!frame_before(frame, (FrameRecord_t *)heap->pdata[parent]))
+            break;
+        heap->pdata[i] = heap->pdata[parent];
+        i = parent;
+    }
+    heap->pdata[i] = frame;
+}
+
+static FrameRecord_t *
+heap_pop(GPtrArray *heap)
+{
+    FrameRecord_t *top = (FrameRecord_t *)heap->pdata[0];
+    FrameRecord_t *last = (FrameRecord_t *)heap->pdata[heap->len - 1];
+    guint i = 0;
+
+    g_ptr_array_set_size(heap, heap->len - 1);
+    if (heap->len == 0)
+        return top;
+
+    for (;;) {
+        guint child = 2 * i + 1;
+        if (child >= heap->len)
+            break;
+        if (child + 1 < heap->len &&
+            frame_before((FrameRecord_t *)heap->pdata[child + 1], (FrameRecord_t *)heap->pdata[child]))
+            child++;
+        if (!frame_before((FrameRecord_t *)heap->pdata[child], last))
+            break;
+        heap->pdata[i] = heap->pdata[child];
+        i = child;
+    }
+    heap->pdata[i] = last;
+    return top;
+}
+
+static gboolean
+rec_write(wtap_dumper *pdh, const wtap_rec *rec, const guint8 *data, guint num,
+          const char *infile, const char *outfile, int file_type_subtype)
 {
     int    err;
     gchar  *err_info;
 
-    DEBUG_PRINT("\nDumping frame (offset=%" G_GINT64_MODIFIER "u)\n",
-                frame->offset);
+    DEBUG_PRINT("\nDumping frame (num=%u)\n", num);
+
+    /* Dump frame to outfile */
+    if (!wtap_dump(pdh, rec, data, &err, &err_info)) {
+        cfile_write_failure_message("reordercap", infile, outfile, err,
+                                    err_info, num, file_type_subtype);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static gboolean
+frame_write(FrameRecord_t *frame, wtap *wth, wtap_dumper *pdh,
+            const char *infile, const char *outfile)
+{
+    return rec_write(pdh, &frame->rec, frame->data, frame->num, infile, outfile,
+                     wtap_file_type_subtype(wth));
+}
+
+static wtap_dumper *
+output_open(const char *outfile, wtap *wth, const wtap_dump_params *params)
+{
+    wtap_dumper *pdh;
+    int          err;
+
+    /* Open outfile (same filetype/encap as input file) */
+    if (strcmp(outfile, "-") == 0) {
+      pdh = wtap_dump_open_stdout(wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, params, &err);
+    } else {
+      pdh = wtap_dump_open(outfile, wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, params, &err);
+    }
+
+    if (pdh == NULL) {
+        cfile_dump_open_failure_message("reordercap", outfile, err,
+                                        wtap_file_type_subtype(wth));
+    }
+    return pdh;
+}
+
+static void
+sorter_init(FrameSorter_t *sorter, gsize mem_limit)
+{
+    sorter->heap = g_ptr_array_new();
+    sorter->mem_used = 0;
+    sorter->mem_limit = mem_limit;
+    sorter->run = 0;
+    sorter->last_key = NSTIME_PACKED_UNSET;
+    sorter->run_pdh = NULL;
+    sorter->run_files = g_ptr_array_new_with_free_func(g_free);
+}
+
+static gboolean
+sorter_close_run(FrameSorter_t *sorter)
+{
+    int err;
+    gboolean ok = wtap_dump_close(sorter->run_pdh, &err);
+
+    sorter->run_pdh = NULL;
+    if (!ok) {
+        cfile_close_failure_message((const char *)g_ptr_array_index(sorter->run_files, sorter->run_files->len - 1), err);
+    }
+    return ok;
+}
+
+/* Write the earliest frame of the heap to the current run, starting a new
+   run in a temporary file when the frame belongs to the next one. */
+static gboolean
+sorter_spill_frame(FrameSorter_t *sorter, wtap *wth, const wtap_dump_params *params,
+                   const char *infile)
+{
+    FrameRecord_t *frame = heap_pop(sorter->heap);
+    gboolean       ok;
 
+    if (sorter->run_pdh == NULL || frame->run != sorter->run) {
+        char *tmpname;
+        int   err;
 
-    /* Re-read the frame from the stored location */
-    if (!wtap_seek_read(wth, frame->offset, rec, buf, &err, &err_info)) {
-        if (err != 0) {
-            /* Print a message noting that the read failed somewhere along the line. */
-            fprintf(stderr,
-                    "reordercap: An error occurred while re-reading \"%s\".\n",
-                    infile);
-            cfile_read_failure_message("reordercap", infile, err, err_info);
-            exit(1);
+        if (sorter->run_pdh != NULL && !sorter_close_run(sorter)) {
+            frame_free(frame);
+            return FALSE;
         }
+        sorter->run_pdh = wtap_dump_open_tempfile(&tmpname, "reordercap",
+                                                  wtap_file_type_subtype(wth),
+                                                  WTAP_UNCOMPRESSED, params, &err);
+        if (sorter->run_pdh == NULL) {
+            cfile_dump_open_failure_message("reordercap",
+                                            tmpname ? tmpname : "temporary file",
+                                            err, wtap_file_type_subtype(wth));
+            frame_free(frame);
+            return FALSE;
+        }
+        g_ptr_array_add(sorter->run_files, g_strdup(tmpname));
+        sorter->run = frame->run;
+        DEBUG_PRINT("Starting run %u in %s\n", sorter->run, tmpname);
     }
 
-    /* Copy, and set length and timestamp from item. */
-    /* TODO: remove when wtap_seek_read() fills in rec,
-       including time stamps, for all file types  */
-    rec->ts = frame->frame_time;
+    ok = frame_write(frame, wth, sorter->run_pdh, infile,
+                     (const char *)g_ptr_array_index(sorter->run_files, sorter->run_files->len - 1));
+    sorter->last_key = frame->sort_key;
+    sorter->mem_used -= sizeof(FrameRecord_t) + rec_data_len(&frame->rec);
+    frame_free(frame);
+    return ok;
+}
 
-    /* Dump frame to outfile */
-    if (!wtap_dump(pdh, rec, ws_buffer_start_ptr(buf), &err, &err_info)) {
-        cfile_write_failure_message("reordercap", infile, outfile, err,
-                                    err_info, frame->num,
-                                    wtap_file_type_subtype(wth));
-        exit(1);
+static gboolean
+sorter_add(FrameSorter_t *sorter, FrameRecord_t *frame, gsize size, wtap *wth,
+           const wtap_dump_params *params, const char *infile)
+{
+    /* Once writing, a frame older than the current run's last frame
+       can only go into the next run. */
+    if (sorter->run_pdh != NULL && frame->sort_key < sorter->last_key) {
+        frame->run = sorter->run + 1;
+    } else {
+        frame->run = sorter->run;
     }
+    heap_push(sorter->heap, frame);
+    sorter->mem_used += size;
+
+    while (sorter->mem_used > sorter->mem_limit && sorter->heap->len > 0) {
+        if (!sorter_spill_frame(sorter, wth, params, infile))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static void
+sorter_cleanup(FrameSorter_t *sorter)
+{
+    guint i;
+    int   err;
+
+    for (i = 0; i < sorter->heap->len; i++) {
+        frame_free((FrameRecord_t *)sorter->heap->pdata[i]);
+    }
+    g_ptr_array_free(sorter->heap, TRUE);
+
+    /* Only still open if we gave up half way through */
+    if (sorter->run_pdh != NULL) {
+        wtap_dump_close(sorter->run_pdh, &err);
+        sorter->run_pdh = NULL;
+    }
+    for (i = 0; i < sorter->run_files->len; i++) {
+        ws_unlink((const char *)g_ptr_array_index(sorter->run_files, i));
+    }
+    g_ptr_array_free(sorter->run_files, TRUE);
 }
 
-/* Comparing timestamps between 2 frames.
-   negative if (t1 < t2)
-   zero     if (t1 == t2)
-   positive if (t1 > t2)
-*/
-static int
-frames_compare(gconstpointer a, gconstpointer b)
+static gboolean
+run_read_next(SortedRun_t *run, GPtrArray *heap)
 {
-    const FrameRecord_t *frame1 = *(const FrameRecord_t *const *) a;
-    const FrameRecord_t *frame2 = *(const FrameRecord_t *const *) b;
+    int     err;
+    gchar  *err_info;
+    gint64  data_offset;
 
-    const nstime_t *time1 = &frame1->frame_time;
-    const nstime_t *time2 = &frame2->frame_time;
+    if (run->wth == NULL) {
+        if (heap->len > 0) {
+            run->sort_key = ((FrameRecord_t *)heap->pdata[0])->sort_key;
+        } else {
+            run->done = TRUE;
+        }
+        return TRUE;
+    }
 
-    return nstime_cmp(time1, time2);
+    if (run->left > 0 && wtap_read(run->wth, &err, &err_info, &data_offset)) {
+        run->left--;
+        run->sort_key = rec_sort_key(wtap_get_rec(run->wth));
+        return TRUE;
+    }
+    if (run->left > 0 && err != 0) {
+        cfile_read_failure_message("reordercap", run->filename, err, err_info);
+        return FALSE;
+    }
+    run->done = TRUE;
+    return TRUE;
+}
+
+/*
+ * Merge the sorted runs into the output file, reading each run sequentially.
+ * The first prefix_frames frames of the input file, which were in order and
+ * not kept, are read again as the first run; the frames still in the heap
+ * are the last one.
+ */
+static gboolean
+merge_runs(FrameSorter_t *sorter, const char *infile, guint prefix_frames,
+           wtap *wth, wtap_dumper *pdh, const char *outfile)
+{
+    SortedRun_t *runs;
+    guint        num_runs = 0;
+    guint        i;
+    guint32      num = 0;
+    gboolean     ok = TRUE;
+
+    runs = g_new0(SortedRun_t, sorter->run_files->len + 2);
+    if (prefix_frames > 0) {
+        runs[num_runs].filename = infile;
+        runs[num_runs].left = prefix_frames;
+        num_runs++;
+    }
+    for (i = 0; i < sorter->run_files->len; i++) {
+        runs[num_runs].filename = (const char *)g_ptr_array_index(sorter->run_files, i);
+        runs[num_runs].left = G_MAXUINT;
+        num_runs++;
+    }
+    for (i = 0; i < num_runs; i++) {
+        int     err;
+        gchar  *err_info;
+
+        runs[i].wth = wtap_open_offline(runs[i].filename, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+        if (runs[i].wth == NULL) {
+            cfile_open_failure_message("reordercap", runs[i].filename, err, err_info);
+            ok = FALSE;
+            break;
+        }
+        if (!run_read_next(&runs[i], sorter->heap)) {
+            ok = FALSE;
+            break;
+        }
+    }
+    if (ok && sorter->heap->len > 0) {
+        runs[num_runs].filename = infile;
+        run_read_next(&runs[num_runs], sorter->heap);
+        num_runs++;
+    }
+
+    while (ok) {
+        SortedRun_t *next = NULL;
+
+        /* There are few runs, so a linear scan for the earliest is fine. */
+        for (i = 0; i < num_runs; i++) {
+            if (!runs[i].done && (next == NULL || runs[i].sort_key < next->sort_key)) {
+                next = &runs[i];
+            }
+        }
+        if (next == NULL)
+            break;
+
+        num++;
+        if (next->wth == NULL) {
+            FrameRecord_t *frame = heap_pop(sorter->heap);
+
+            ok = rec_write(pdh, &frame->rec, frame->data, num, infile, outfile,
+                           wtap_file_type_subtype(wth));
+            frame_free(frame);
+        } else {
+            ok = rec_write(pdh, wtap_get_rec(next->wth), wtap_get_buf_ptr(next->wth), num,
+                           next->filename, outfile, wtap_file_type_subtype(wth));
+        }
+        if (ok)
+            ok = run_read_next(next, sorter->heap);
+    }
+
+    for (i = 0; i < num_runs; i++) {
+        if (runs[i].wth != NULL)
+            wtap_close(runs[i].wth);
+    }
+    g_free(runs);
+    return ok;
 }
 
 /*
@@ -168,20 +523,20 @@ main(int argc, char *argv[])
     char *init_progfile_dir_error;
     wtap *wth = NULL;
     wtap_dumper *pdh = NULL;
-    wtap_rec dump_rec;
-    Buffer buf;
     int err;
     gchar *err_info;
     gint64 data_offset;
-    const wtap_rec *rec;
     guint wrong_order_count = 0;
     gboolean write_output_regardless = TRUE;
-    guint i;
+    guint sort_memory_mb = DEFAULT_SORT_MEMORY_MB;
+    guint num_frames = 0;
     wtap_dump_params params;
     int                          ret = EXIT_SUCCESS;
 
-    GPtrArray *frames;
-    FrameRecord_t *prevFrame = NULL;
+    FrameSorter_t sorter;
+    gint64 prev_key = NSTIME_PACKED_UNSET;
+    guint prefix_frames = 0;
+    gboolean streaming;
 
     int opt;
     static const struct option long_options[] = {
@@ -234,8 +589,11 @@ main(int argc, char *argv[])
     wtap_init(TRUE);
 
     /* Process the options first */
-    while ((opt = getopt_long(argc, argv, "hnv", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "hm:nv", long_options, NULL)) != -1) {
         switch (opt) {
+            case 'm':
+                sort_memory_mb = get_positive_int(optarg, "sort memory size");
+                break;
             case 'n':
                 write_output_regardless = FALSE;
                 break;
@@ -285,88 +643,114 @@ main(int argc, char *argv[])
 
     wtap_dump_params_init(&params, wth);
 
-    /* Open outfile (same filetype/encap as input file) */
-    if (strcmp(outfile, "-") == 0) {
-      pdh = wtap_dump_open_stdout(wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, &params, &err);
-    } else {
-      pdh = wtap_dump_open(outfile, wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, &params, &err);
-    }
-    g_free(params.idb_inf);
-    params.idb_inf = NULL;
-
+    pdh = output_open(outfile, wth, &params);
     if (pdh == NULL) {
-        cfile_dump_open_failure_message("reordercap", outfile, err,
-                                        wtap_file_type_subtype(wth));
+        g_free(params.idb_inf);
         wtap_dump_params_cleanup(&params);
         ret = OUTPUT_FILE_ERROR;
         goto clean_exit;
     }
 
-    /* Allocate the array of frame pointers. */
-    frames = g_ptr_array_new();
+    sorter_init(&sorter, (gsize)sort_memory_mb * 1024 * 1024);
+
+    /*
+     * As long as the frames are in order they are written straight to the
+     * output, and aren't kept.  If the output can't be rewritten, or with
+     * -n, they're only counted.  At the first frame out of order, the
+     * output is started again and those first frames are read again from
+     * the input as the first of the sorted runs.
+     */
+    streaming = write_output_regardless && strcmp(outfile, "-") != 0;
 
     /* Read each frame from infile */
     while (wtap_read(wth, &err, &err_info, &data_offset)) {
+        wtap_rec *rec = wtap_get_rec(wth);
         FrameRecord_t *newFrameRecord;
+        gint64 key = rec_sort_key(rec);
+        gsize size;
 
-        rec = wtap_get_rec(wth);
-
-        newFrameRecord = g_slice_new(FrameRecord_t);
-        newFrameRecord->num = frames->len + 1;
-        newFrameRecord->offset = data_offset;
-        if (rec->presence_flags & WTAP_HAS_TS) {
-            newFrameRecord->frame_time = rec->ts;
-        } else {
-            nstime_set_unset(&newFrameRecord->frame_time);
+        ++num_frames;
+        if (num_frames > 1 && key < prev_key) {
+           wrong_order_count++;
+        }
+        prev_key = key;
+
+        if (wrong_order_count == 0) {
+            prefix_frames++;
+            if (streaming &&
+                !rec_write(pdh, rec, wtap_get_buf_ptr(wth), num_frames, infile,
+                           outfile, wtap_file_type_subtype(wth))) {
+                ret = OUTPUT_FILE_ERROR;
+                goto sort_done;
+            }
+            continue;
         }
 
-        if (prevFrame && frames_compare(&newFrameRecord, &prevFrame) < 0) {
-           wrong_order_count++;
+        if (streaming) {
+            DEBUG_PRINT("Frame %u out of order, rewriting the output\n", num_frames);
+            streaming = FALSE;
+            if (!wtap_dump_close(pdh, &err)) {
+                pdh = NULL;
+                cfile_close_failure_message(outfile, err);
+                ret = OUTPUT_FILE_ERROR;
+                goto sort_done;
+            }
+            pdh = output_open(outfile, wth, &params);
+            if (pdh == NULL) {
+                ret = OUTPUT_FILE_ERROR;
+                goto sort_done;
+            }
         }
 
-        g_ptr_array_add(frames, newFrameRecord);
-        prevFrame = newFrameRecord;
+        newFrameRecord = frame_new(rec, wtap_get_buf_ptr(wth), num_frames, &size);
+        if (!sorter_add(&sorter, newFrameRecord, size, wth, &params, infile)) {
+            ret = OUTPUT_FILE_ERROR;
+            goto sort_done;
+        }
     }
     if (err != 0) {
       /* Print a message noting that the read failed somewhere along the line. */
       cfile_read_failure_message("reordercap", infile, err, err_info);
     }
 
-    printf("%u frames, %u out of order\n", frames->len, wrong_order_count);
-
-    /* Sort the frames */
-    if (wrong_order_count > 0) {
-        g_ptr_array_sort(frames, frames_compare);
-    }
-
-    /* Write out each sorted frame in turn */
-    wtap_rec_init(&dump_rec);
-    ws_buffer_init(&buf, 1500);
-    for (i = 0; i < frames->len; i++) {
-        FrameRecord_t *frame = (FrameRecord_t *)frames->pdata[i];
-
-        /* Avoid writing if already sorted and configured to */
-        if (write_output_regardless || (wrong_order_count > 0)) {
-            frame_write(frame, wth, pdh, &dump_rec, &buf, infile, outfile);
+    printf("%u frames, %u out of order\n", num_frames, wrong_order_count);
+
+    /* Avoid writing if already sorted and configured to */
+    if (streaming) {
+        /* Everything has been written already. */
+    } else if (write_output_regardless || (wrong_order_count > 0)) {
+        if (sorter.run_files->len > 0) {
+            while (sorter.heap->len > 0) {
+                if (!sorter_spill_frame(&sorter, wth, &params, infile)) {
+                    ret = OUTPUT_FILE_ERROR;
+                    goto sort_done;
+                }
+            }
+            if (!sorter_close_run(&sorter)) {
+                ret = OUTPUT_FILE_ERROR;
+                goto sort_done;
+            }
         }
-        g_slice_free(FrameRecord_t, frame);
-    }
-    wtap_rec_cleanup(&dump_rec);
-    ws_buffer_free(&buf);
-
-    if (!write_output_regardless && (wrong_order_count == 0)) {
+        DEBUG_PRINT("Merging %u in-order frames with %u sorted runs\n",
+                    prefix_frames, sorter.run_files->len);
+        if (!merge_runs(&sorter, infile, prefix_frames, wth, pdh, outfile)) {
+            ret = OUTPUT_FILE_ERROR;
+            goto sort_done;
+        }
+    } else {
         printf("Not writing output file because input file is already in order.\n");
     }
 
-    /* Free the whole array */
-    g_ptr_array_free(frames, TRUE);
+sort_done:
+    /* Free remaining frames and remove the temporary files */
+    sorter_cleanup(&sorter);
+    g_free(params.idb_inf);
+    params.idb_inf = NULL;
 
     /* Close outfile */
-    if (!wtap_dump_close(pdh, &err)) {
+    if (pdh != NULL && !wtap_dump_close(pdh, &err) && ret == EXIT_SUCCESS) {
         cfile_close_failure_message(outfile, err);
-        wtap_dump_params_cleanup(&params);
         ret = OUTPUT_FILE_ERROR;
-        goto clean_exit;
     }
     wtap_dump_params_cleanup(&params);
 
@@ -2634,6 +2634,11 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
  * Input:
  *   (m) follow  - follow protocol request (e.g. HTTP)
  *   (m) filter  - filter request (e.g. tcp.stream == 1)
+ *   (o) offset  - return only payloads from this stream offset on, default 0
+ *   (o) len     - return only payloads starting before offset + len; 0 returns none
+ *
+ * Each request still taps the whole capture and indexes the whole stream;
+ * offset and len only limit how much of it is sent back.
  *
  * Output object with attributes:
  *
@@ -2647,6 +2652,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
  *   (o) payloads - array of object with attributes:
  *                  (o) s - set if server sent, else client
  *                  (m) n - packet number
+ *                  (m) o - stream offset of the payload
  *                  (m) d - data base64 encoded
  */
 static void
@@ -2654,6 +2660,8 @@ sharkd_session_process_follow(char *buf, const jsmntok_t *tokens, int count)
 {
 	const char *tok_follow = json_find_attr(buf, tokens, count, "follow");
 	const char *tok_filter = json_find_attr(buf, tokens, count, "filter");
+	const char *tok_offset = json_find_attr(buf, tokens, count, "offset");
+	const char *tok_len    = json_find_attr(buf, tokens, count, "len");
 
 	register_follow_t *follower;
 	GString *tap_error;
@@ -2661,10 +2669,23 @@ sharkd_session_process_follow(char *buf, const jsmntok_t *tokens, int count)
 	follow_info_t *follow_info;
 	const char *host;
 	char *port;
+	guint64 offset = 0, len = G_MAXUINT64;
 
 	if (!tok_follow || !tok_filter)
 		return;
 
+	if (tok_offset)
+	{
+		if (!ws_strtou64(tok_offset, NULL, &offset))
+			return;
+	}
+
+	if (tok_len)
+	{
+		if (!ws_strtou64(tok_len, NULL, &len))
+			return;
+	}
+
 	follower = get_follow_by_name(tok_follow);
 	if (!follower)
 	{
@@ -2713,18 +2734,24 @@ sharkd_session_process_follow(char *buf, const jsmntok_t *tokens, int count)
 
 	if (follow_info->payload)
 	{
+		follow_index_t *index = follow_index_new(follow_info);
 		follow_record_t *follow_record;
-		GList *cur;
+		guint i;
 		gboolean sepa = FALSE;
 
 		sharkd_json_array_open(TRUE, "payloads");
-		for (cur = g_list_last(follow_info->payload); cur; cur = g_list_previous(cur))
+		/* An empty range is an empty page */
+		for (i = len ? follow_index_find(index, offset) : index->count; i < index->count; i++)
 		{
-			follow_record = (follow_record_t *) cur->data;
+			if (index->offsets[i] > offset && index->offsets[i] - offset >= len)
+				break;
+
+			follow_record = index->records[i];
 
 			sharkd_json_object_open(sepa);
 
 			sharkd_json_value_anyf(FALSE, "n", "%u", follow_record->packet_num);
+			sharkd_json_value_anyf(TRUE, "o", "%" G_GUINT64_FORMAT, index->offsets[i]);
 			sharkd_json_value_base64(TRUE, "d", follow_record->data->data, follow_record->data->len);
 
 			if (follow_record->is_server)
@@ -2734,6 +2761,7 @@ sharkd_session_process_follow(char *buf, const jsmntok_t *tokens, int count)
 			sepa = TRUE;
 		}
 		sharkd_json_array_close();
+		follow_index_free(index);
 	}
 
 	sharkd_json_object_close();
@@ -24,10 +24,18 @@ class case_unittests(subprocesstest.SubprocessTestCase):
         '''exntest'''
         self.assertRun(program('exntest'), env=base_env)
 
+    def test_unit_heur_test(self, program, base_env):
+        '''heur_test'''
+        self.assertRun(program('heur_test'), env=base_env)
+
     def test_unit_oids_test(self, program, base_env):
         '''oids_test'''
         self.assertRun(program('oids_test'), env=base_env)
 
+    def test_unit_proto_data_test(self, program, base_env):
+        '''proto_data_test'''
+        self.assertRun(program('proto_data_test'), env=base_env)
+
     def test_unit_reassemble_test(self, program, base_env):
         '''reassemble_test'''
         self.assertRun(program('reassemble_test'), env=base_env)
@@ -48,6 +56,12 @@ class case_unittests(subprocesstest.SubprocessTestCase):
             '--verbose'
         ), env=base_env)
 
+    def test_unit_wtap_batch_test(self, program, capture_file, base_env):
+        '''wtap_batch_test'''
+        self.assertRun((program('wtap_batch_test'),
+            capture_file('sip.pcapng')
+        ), env=base_env)
+
     def test_unit_fieldcount(self, cmd_tshark, test_env):
         '''fieldcount'''
         self.assertRun((cmd_tshark, '-G', 'fieldcount'), env=test_env)
@@ -3071,6 +3071,12 @@ process_packet_second_pass(capture_file *cf, epan_dissect_t *edt,
   return passed || fdata->flags.dependent_of_displayed;
 }
 
+/*
+ * How many packets to read in the first pass between letting queued name
+ * lookups make progress; each time costs a MaxMind poll and a select().
+ */
+#define FIRST_PASS_LOOKUP_INTERVAL 256
+
 static gboolean
 process_cap_file(capture_file *cf, char *save_file, int out_file_type,
     gboolean out_file_name_res, int max_packet_count, gint64 max_byte_count)
@@ -3078,6 +3084,7 @@ process_cap_file(capture_file *cf, char *save_file, int out_file_type,
   gboolean     success = TRUE;
   wtap_dumper *pdh;
   guint32      framenum;
+  guint        packets_since_lookup = 0;
   int          err = 0, err_pass1 = 0;
   gchar       *err_info = NULL, *err_info_pass1 = NULL;
   gint64       data_offset;
@@ -3172,6 +3179,14 @@ process_cap_file(capture_file *cf, char *save_file, int out_file_type,
 
     tshark_debug("tshark: reading records for first pass");
     while (wtap_read(cf->provider.wth, &err, &err_info, &data_offset)) {
+      /*
+       * Let any name lookups queued by earlier packets make progress
+       * in the background while we dissect.
+       */
+      if (++packets_since_lookup == FIRST_PASS_LOOKUP_INTERVAL) {
+        host_name_lookup_process();
+        packets_since_lookup = 0;
+      }
       if (process_packet_first_pass(cf, edt, data_offset, wtap_get_rec(cf->provider.wth),
                                     wtap_get_buf_ptr(cf->provider.wth))) {
         /* Stop reading if we have the maximum number of packets;
@@ -3220,6 +3235,13 @@ process_cap_file(capture_file *cf, char *save_file, int out_file_type,
 
     tshark_debug("tshark: done with first pass");
 
+    /*
+     * Resolve the addresses seen in the first pass in bulk, so that the
+     * second pass finds them in the cache rather than blocking on each
+     * one in turn.
+     */
+    host_name_lookup_wait();
+
     if (do_dissection) {
       gboolean create_proto_tree;
 
@@ -45,13 +45,42 @@ typedef struct expert_entry
 } expert_entry;
 
 
+/* Key for finding the entry of a protocol/summary pair */
+typedef struct expert_entry_key
+{
+    const gchar *protocol;
+    const gchar *summary;
+    guint        index;     /* into ei_array */
+} expert_entry_key;
+
+
 /* Overall struct for storing all data seen */
 typedef struct expert_tapdata_t {
     GArray       *ei_array[max_level]; /* expert info items */
+    GHashTable   *ei_index[max_level]; /* expert_entry_key -> itself */
     GStringChunk *text;         /* for efficient storage of summary strings */
 } expert_tapdata_t;
 
 
+static guint
+expert_entry_key_hash(gconstpointer v)
+{
+    const expert_entry_key *key = (const expert_entry_key *)v;
+
+    return g_str_hash(key->protocol) * 31 + g_str_hash(key->summary);
+}
+
+static gboolean
+expert_entry_key_equal(gconstpointer v, gconstpointer w)
+{
+    const expert_entry_key *key1 = (const expert_entry_key *)v;
+    const expert_entry_key *key2 = (const expert_entry_key *)w;
+
+    return (strcmp(key1->protocol, key2->protocol) == 0) &&
+           (strcmp(key1->summary, key2->summary) == 0);
+}
+
+
 /* Reset expert stats */
 static void
 expert_stat_reset(void *tapdata)
@@ -66,6 +95,7 @@ expert_stat_reset(void *tapdata)
     /* Empty each of the arrays */
     for (n=0; n < max_level; n++) {
         g_array_set_size(etd->ei_array[n], 0);
+        g_hash_table_remove_all(etd->ei_index[n]);
     }
 }
 
@@ -79,7 +109,8 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
     severity_level_t     severity_level;
     expert_entry         tmp_entry;
     expert_entry        *entry;
-    guint                n;
+    expert_entry_key     lookup_key;
+    expert_entry_key    *key;
 
     switch (ei->severity) {
         case PI_COMMENT:
@@ -107,15 +138,14 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
         return TRUE;
     }
 
-    /* If a duplicate just bump up frequency.
-       TODO: could make more efficient by avoiding linear search...*/
-    for (n=0; n < data->ei_array[severity_level]->len; n++) {
-        entry = &g_array_index(data->ei_array[severity_level], expert_entry, n);
-        if ((strcmp(ei->protocol, entry->protocol) == 0) &&
-            (strcmp(ei->summary, entry->summary) == 0)) {
-            entry->frequency++;
-            return TRUE;
-        }
+    /* If a duplicate just bump up frequency */
+    lookup_key.protocol = ei->protocol;
+    lookup_key.summary = ei->summary;
+    key = (expert_entry_key *)g_hash_table_lookup(data->ei_index[severity_level], &lookup_key);
+    if (key != NULL) {
+        entry = &g_array_index(data->ei_array[severity_level], expert_entry, key->index);
+        entry->frequency++;
+        return TRUE;
     }
 
     /* Else Add new item to end of list for severity level */
@@ -128,6 +158,12 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
     /* Store a copy of the expert entry */
     g_array_append_val(data->ei_array[severity_level], tmp_entry);
 
+    key = g_new(expert_entry_key, 1);
+    key->protocol = entry->protocol;
+    key->summary = entry->summary;
+    key->index = data->ei_array[severity_level]->len - 1;
+    g_hash_table_insert(data->ei_index[severity_level], key, key);
+
     return TRUE;
 }
 
@@ -188,6 +224,7 @@ expert_tapdata_free(expert_tapdata_t* hs)
 {
     for (int n = 0; n < max_level; n++) {
         g_array_free(hs->ei_array[n], TRUE);
+        g_hash_table_destroy(hs->ei_index[n]);
     }
     g_string_chunk_free(hs->text);
     g_free(hs);
@@ -249,6 +286,7 @@ static void expert_stat_init(const char *opt_arg, void *userdata _U_)
     /* Allocate GArray for each severity level */
     for (n=0; n < max_level; n++) {
         hs->ei_array[n] = g_array_sized_new(FALSE, FALSE, sizeof(expert_entry), 1000);
+        hs->ei_index[n] = g_hash_table_new_full(expert_entry_key_hash, expert_entry_key_equal, g_free, NULL);
     }
 
     /**********************************************/
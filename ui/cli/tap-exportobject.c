@@ -78,8 +78,12 @@ local_eo_save_entry(const gchar *save_as_filename, export_object_entry_t *entry)
 }
 
 typedef struct _export_object_list_gui_t {
-    GSList *entries;
+    GPtrArray *entries;         /* entries kept until eo_draw */
     register_eo_t* eo;
+    const gchar *save_in_path;
+    gboolean dir_checked;       /* save_in_path has been created or found unusable */
+    gboolean dir_ok;
+    gboolean all_saved;
 } export_object_list_gui_t;
 
 static GHashTable* eo_opts = NULL;
@@ -133,19 +137,92 @@ gboolean eo_tap_opt_add(const char *option_string)
     return FALSE;
 }
 
+static gboolean
+object_list_check_dir(export_object_list_gui_t *object_list)
+{
+    if (object_list->dir_checked)
+        return object_list->dir_ok;
+
+    object_list->dir_checked = TRUE;
+    object_list->dir_ok = FALSE;
+
+    if (!g_file_test(object_list->save_in_path, G_FILE_TEST_IS_DIR)) {
+        /* If the destination directory (or its parents) do not exist, create them. */
+        if (g_mkdir_with_parents(object_list->save_in_path, 0755) == -1) {
+            fprintf(stderr, "Failed to create export objects output directory \"%s\": %s\n",
+                    object_list->save_in_path, g_strerror(errno));
+            return FALSE;
+        }
+    }
+
+    if (strlen(object_list->save_in_path) >= EXPORT_OBJECT_MAXFILELEN) {
+        object_list->all_saved = FALSE;
+        return FALSE;
+    }
+
+    object_list->dir_ok = TRUE;
+    return TRUE;
+}
+
+static void
+object_list_save_entry(export_object_list_gui_t *object_list, export_object_entry_t *entry)
+{
+    const gchar *save_in_path = object_list->save_in_path;
+    GString *safe_filename = NULL;
+    gchar *save_as_fullpath = NULL;
+    int count = 0;
+
+    if (!object_list_check_dir(object_list))
+        return;
+
+    do {
+        g_free(save_as_fullpath);
+        if (entry->filename) {
+            safe_filename = eo_massage_str(entry->filename,
+                EXPORT_OBJECT_MAXFILELEN - strlen(save_in_path), count);
+        } else {
+            char generic_name[EXPORT_OBJECT_MAXFILELEN+1];
+            const char *ext;
+            ext = eo_ct2ext(entry->content_type);
+            g_snprintf(generic_name, sizeof(generic_name),
+                "object%u%s%s", entry->pkt_num, ext ? "." : "", ext ? ext : "");
+            safe_filename = eo_massage_str(generic_name,
+                EXPORT_OBJECT_MAXFILELEN - strlen(save_in_path), count);
+        }
+        save_as_fullpath = g_build_filename(save_in_path, safe_filename->str, NULL);
+        g_string_free(safe_filename, TRUE);
+    } while (g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS) && ++count < 1000);
+    if (!local_eo_save_entry(save_as_fullpath, entry))
+        object_list->all_saved = FALSE;
+    g_free(save_as_fullpath);
+}
+
 static void
 object_list_add_entry(void *gui_data, export_object_entry_t *entry)
 {
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)gui_data;
 
-    object_list->entries = g_slist_append(object_list->entries, entry);
+    /*
+     * Most protocols hand us complete objects, so write them out now
+     * rather than holding every object's payload until the end of the
+     * capture.
+     */
+    if (!get_eo_updates_entries(object_list->eo)) {
+        object_list_save_entry(object_list, entry);
+        eo_free_entry(entry);
+        return;
+    }
+
+    g_ptr_array_add(object_list->entries, entry);
 }
 
 static export_object_entry_t*
 object_list_get_entry(void *gui_data, int row) {
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)gui_data;
 
-    return (export_object_entry_t *)g_slist_nth_data(object_list->entries, row);
+    if (row < 0 || (guint)row >= object_list->entries->len)
+        return NULL;
+    return (export_object_entry_t *)g_ptr_array_index(object_list->entries, row);
 }
 
 /* This is just for writing Exported Objects to a file */
@@ -154,63 +231,22 @@ eo_draw(void *tapdata)
 {
     export_object_list_t *tap_object = (export_object_list_t *)tapdata;
     export_object_list_gui_t *object_list = (export_object_list_gui_t*)tap_object->gui_data;
-    GSList *slist = object_list->entries;
-    export_object_entry_t *entry;
-    gboolean all_saved = TRUE;
-    gchar* save_in_path = (gchar*)g_hash_table_lookup(eo_opts, proto_get_protocol_filter_name(get_eo_proto_id(object_list->eo)));
-    GString *safe_filename = NULL;
-    gchar *save_as_fullpath = NULL;
-    int count = 0;
+    guint i;
 
-    if (!g_file_test(save_in_path, G_FILE_TEST_IS_DIR)) {
-        /* If the destination directory (or its parents) do not exist, create them. */
-        if (g_mkdir_with_parents(save_in_path, 0755) == -1) {
-            fprintf(stderr, "Failed to create export objects output directory \"%s\": %s\n",
-                    save_in_path, g_strerror(errno));
-            return;
-        }
-    }
-
-    if ((strlen(save_in_path) < EXPORT_OBJECT_MAXFILELEN)) {
-        while (slist) {
-            entry = (export_object_entry_t *)slist->data;
-            do {
-                g_free(save_as_fullpath);
-                if (entry->filename) {
-                    safe_filename = eo_massage_str(entry->filename,
-                        EXPORT_OBJECT_MAXFILELEN - strlen(save_in_path), count);
-                } else {
-                    char generic_name[EXPORT_OBJECT_MAXFILELEN+1];
-                    const char *ext;
-                    ext = eo_ct2ext(entry->content_type);
-                    g_snprintf(generic_name, sizeof(generic_name),
-                        "object%u%s%s", entry->pkt_num, ext ? "." : "", ext ? ext : "");
-                    safe_filename = eo_massage_str(generic_name,
-                        EXPORT_OBJECT_MAXFILELEN - strlen(save_in_path), count);
-                }
-                save_as_fullpath = g_build_filename(save_in_path, safe_filename->str, NULL);
-                g_string_free(safe_filename, TRUE);
-            } while (g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS) && ++count < 1000);
-            count = 0;
-            if (!local_eo_save_entry(save_as_fullpath, entry))
-                all_saved = FALSE;
-            g_free(save_as_fullpath);
-            save_as_fullpath = NULL;
-            slist = slist->next;
-        }
-    }
-    else
-    {
-        all_saved = FALSE;
+    /* Objects that were saved as they were added are already gone. */
+    for (i = 0; i < object_list->entries->len; i++) {
+        object_list_save_entry(object_list,
+            (export_object_entry_t *)g_ptr_array_index(object_list->entries, i));
     }
+    g_ptr_array_set_size(object_list->entries, 0);
 
-    if (!all_saved)
+    if (!object_list->all_saved)
         fprintf(stderr, "Export objects (%s): Some files could not be saved.\n",
                     proto_get_protocol_filter_name(get_eo_proto_id(object_list->eo)));
 }
 
 static void
-exportobject_handler(gpointer key, gpointer value _U_, gpointer user_data _U_)
+exportobject_handler(gpointer key, gpointer value, gpointer user_data _U_)
 {
     GString *error_msg;
     export_object_list_t *tap_data;
@@ -232,6 +268,9 @@ exportobject_handler(gpointer key, gpointer value _U_, gpointer user_data _U_)
     tap_data->gui_data = (void*)object_list;
 
     object_list->eo = eo;
+    object_list->entries = g_ptr_array_new_with_free_func((GDestroyNotify)eo_free_entry);
+    object_list->save_in_path = (const gchar*)value;
+    object_list->all_saved = TRUE;
 
     /* Data will be gathered via a tap callback */
     error_msg = register_tap_listener(get_eo_tap_listener_name(eo), tap_data, NULL, 0,
@@ -240,6 +279,7 @@ exportobject_handler(gpointer key, gpointer value _U_, gpointer user_data _U_)
     if (error_msg) {
         fprintf(stderr, "tshark: Can't register %s tap: %s\n", (const char*)key, error_msg->str);
         g_string_free(error_msg, TRUE);
+        g_ptr_array_free(object_list->entries, TRUE);
         g_free(tap_data);
         g_free(object_list);
         return;
@@ -125,6 +125,98 @@ GString *check_field_unit(const char *field_name, int *hf_index, io_graph_item_u
     return err_str;
 }
 
+void merge_io_graph_item(io_graph_item_t *dst, const io_graph_item_t *src, int hf_index, io_graph_item_unit_t item_unit)
+{
+    gboolean new_max = FALSE, new_min = FALSE;
+
+    if (src->first_frame_in_invl != 0) {
+        if (dst->first_frame_in_invl == 0) {
+            dst->first_frame_in_invl = src->first_frame_in_invl;
+        }
+        dst->last_frame_in_invl = src->last_frame_in_invl;
+    }
+
+    dst->frames += src->frames;
+    dst->bytes += src->bytes;
+
+    if (src->fields == 0) {
+        return;
+    }
+
+    /* If dst->fields == 0 nothing has been merged yet, so take the
+     * source's min and max as they are. */
+    switch (hf_index >= 0 ? proto_registrar_get_ftype(hf_index) : FT_NONE) {
+    case FT_UINT8:
+    case FT_UINT16:
+    case FT_UINT24:
+    case FT_UINT32:
+    case FT_UINT40:
+    case FT_UINT48:
+    case FT_UINT56:
+    case FT_UINT64:
+    case FT_INT8:
+    case FT_INT16:
+    case FT_INT24:
+    case FT_INT32:
+    case FT_INT40:
+    case FT_INT48:
+    case FT_INT56:
+    case FT_INT64:
+        if ((src->int_max > dst->int_max) || (dst->fields == 0)) {
+            dst->int_max = src->int_max;
+            new_max = TRUE;
+        }
+        if ((src->int_min < dst->int_min) || (dst->fields == 0)) {
+            dst->int_min = src->int_min;
+            new_min = TRUE;
+        }
+        dst->int_tot += src->int_tot;
+        break;
+    case FT_FLOAT:
+        if ((src->float_max > dst->float_max) || (dst->fields == 0)) {
+            dst->float_max = src->float_max;
+            new_max = TRUE;
+        }
+        if ((src->float_min < dst->float_min) || (dst->fields == 0)) {
+            dst->float_min = src->float_min;
+            new_min = TRUE;
+        }
+        dst->float_tot += src->float_tot;
+        break;
+    case FT_DOUBLE:
+        if ((src->double_max > dst->double_max) || (dst->fields == 0)) {
+            dst->double_max = src->double_max;
+            new_max = TRUE;
+        }
+        if ((src->double_min < dst->double_min) || (dst->fields == 0)) {
+            dst->double_min = src->double_min;
+            new_min = TRUE;
+        }
+        dst->double_tot += src->double_tot;
+        break;
+    case FT_RELATIVE_TIME:
+        if ((nstime_cmp(&src->time_max, &dst->time_max) > 0) || (dst->fields == 0)) {
+            dst->time_max = src->time_max;
+            new_max = TRUE;
+        }
+        if ((nstime_cmp(&src->time_min, &dst->time_min) < 0) || (dst->fields == 0)) {
+            dst->time_min = src->time_min;
+            new_min = TRUE;
+        }
+        nstime_add(&dst->time_tot, &src->time_tot);
+        break;
+    default:
+        break;
+    }
+
+    if ((new_max && item_unit == IOG_ITEM_UNIT_CALC_MAX) ||
+        (new_min && item_unit == IOG_ITEM_UNIT_CALC_MIN)) {
+        dst->extreme_frame_in_invl = src->extreme_frame_in_invl;
+    }
+
+    dst->fields += src->fields;
+}
+
 // Adapted from get_it_value in gtk/io_stat.c.
 double get_io_graph_item(const io_graph_item_t *items_, io_graph_item_unit_t val_units_, int idx, int hf_index_, const capture_file *cap_file, int interval_, int cur_idx_)
 {
@@ -27,35 +27,39 @@
 
 static int pc_proto_id = -1;
 
+/* Find the child of parent_stat_node for the given protocol, if any */
 static GNode*
-find_stat_node(GNode *parent_stat_node, header_field_info *needle_hfinfo)
+find_child_stat_node(ph_stats_t *ps, GNode *parent_stat_node, int proto_id)
+{
+    GHashTable *children;
+
+    children = (GHashTable *)g_hash_table_lookup(ps->children, parent_stat_node);
+    if (!children) {
+        return NULL;
+    }
+    return (GNode *)g_hash_table_lookup(children, GINT_TO_POINTER(proto_id));
+}
+
+static GNode*
+find_stat_node(ph_stats_t *ps, GNode *parent_stat_node, header_field_info *needle_hfinfo)
 {
     GNode		*needle_stat_node, *up_parent_stat_node;
-    header_field_info	*hfinfo;
+    GHashTable		*children;
     ph_stats_node_t	*stats;
 
     /* Look down the tree */
-    needle_stat_node = g_node_first_child(parent_stat_node);
-
-    while (needle_stat_node) {
-        hfinfo = STAT_NODE_HFINFO(needle_stat_node);
-        if (hfinfo &&  hfinfo->id == needle_hfinfo->id) {
-            return needle_stat_node;
-        }
-        needle_stat_node = g_node_next_sibling(needle_stat_node);
+    needle_stat_node = find_child_stat_node(ps, parent_stat_node, needle_hfinfo->id);
+    if (needle_stat_node) {
+        return needle_stat_node;
     }
 
     /* Look up the tree */
     up_parent_stat_node = parent_stat_node;
     while (up_parent_stat_node && up_parent_stat_node->parent)
     {
-        needle_stat_node = g_node_first_child(up_parent_stat_node->parent);
-        while (needle_stat_node) {
-            hfinfo = STAT_NODE_HFINFO(needle_stat_node);
-            if (hfinfo &&  hfinfo->id == needle_hfinfo->id) {
-                return needle_stat_node;
-            }
-            needle_stat_node = g_node_next_sibling(needle_stat_node);
+        needle_stat_node = find_child_stat_node(ps, up_parent_stat_node->parent, needle_hfinfo->id);
+        if (needle_stat_node) {
+            return needle_stat_node;
         }
 
         up_parent_stat_node = up_parent_stat_node->parent;
@@ -73,6 +77,14 @@ find_stat_node(GNode *parent_stat_node, header_field_info *needle_hfinfo)
 
     needle_stat_node = g_node_new(stats);
     g_node_append(parent_stat_node, needle_stat_node);
+
+    children = (GHashTable *)g_hash_table_lookup(ps->children, parent_stat_node);
+    if (!children) {
+        children = g_hash_table_new(g_direct_hash, g_direct_equal);
+        g_hash_table_insert(ps->children, parent_stat_node, children);
+    }
+    g_hash_table_insert(children, GINT_TO_POINTER(needle_hfinfo->id), needle_stat_node);
+
     return needle_stat_node;
 }
 
@@ -98,7 +110,7 @@ process_node(proto_node *ptree_node, GNode *parent_stat_node, ph_stats_t *ps)
         stat_node = parent_stat_node;
         stats = STAT_NODE_STATS(stat_node);
     } else {
-        stat_node = find_stat_node(parent_stat_node, finfo->hfinfo);
+        stat_node = find_stat_node(ps, parent_stat_node, finfo->hfinfo);
 
         stats = STAT_NODE_STATS(stat_node);
         stats->num_pkts_total++;
@@ -147,30 +159,22 @@ process_tree(proto_tree *protocol_tree, ph_stats_t* ps)
 }
 
     static gboolean
-process_record(capture_file *cf, frame_data *frame, column_info *cinfo, ph_stats_t* ps)
+process_record(capture_file *cf, frame_data *frame, column_info *cinfo,
+               epan_dissect_t *edt, wtap_rec *rec, Buffer *buf, ph_stats_t* ps)
 {
-    epan_dissect_t	edt;
-    wtap_rec            rec;
-    Buffer		buf;
     double		cur_time;
 
-    wtap_rec_init(&rec);
-
     /* Load the record from the capture file */
-    ws_buffer_init(&buf, 1500);
-    if (!cf_read_record_r(cf, frame, &rec, &buf))
+    if (!cf_read_record_r(cf, frame, rec, buf))
         return FALSE;	/* failure */
 
     /* Dissect the record   tree  not visible */
-    epan_dissect_init(&edt, cf->epan, TRUE, FALSE);
-    /* Don't fake protocols. We need them for the protocol hierarchy */
-    epan_dissect_fake_protocols(&edt, FALSE);
-    epan_dissect_run(&edt, cf->cd_t, &rec,
-                     frame_tvbuff_new_buffer(&cf->provider, frame, &buf),
+    epan_dissect_run(edt, cf->cd_t, rec,
+                     frame_tvbuff_new_buffer(&cf->provider, frame, buf),
                      frame, cinfo);
 
     /* Get stats from this protocol tree */
-    process_tree(edt.tree, ps);
+    process_tree(edt->tree, ps);
 
     if (frame->flags.has_ts) {
         /* Update times */
@@ -181,10 +185,8 @@ process_record(capture_file *cf, frame_data *frame, column_info *cinfo, ph_stats
             ps->last_time = cur_time;
     }
 
-    /* Free our memory. */
-    epan_dissect_cleanup(&edt);
-    wtap_rec_cleanup(&rec);
-    ws_buffer_free(&buf);
+    /* Get ready for the next record. */
+    epan_dissect_reset(edt);
 
     return TRUE;	/* success */
 }
@@ -204,6 +206,9 @@ ph_stats_new(capture_file *cf)
     gchar	status_str[100];
     int		progbar_nextstep;
     int		progbar_quantum;
+    epan_dissect_t	edt;
+    wtap_rec	rec;
+    Buffer	buf;
 
     if (!cf) return NULL;
 
@@ -216,6 +221,8 @@ ph_stats_new(capture_file *cf)
     ps->stats_tree = g_node_new(NULL);
     ps->first_time = 0.0;
     ps->last_time = 0.0;
+    ps->children = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+            NULL, (GDestroyNotify)g_hash_table_destroy);
 
     /* Update the progress bar when it gets to this value. */
     progbar_nextstep = 0;
@@ -233,6 +240,13 @@ ph_stats_new(capture_file *cf)
     tot_packets = 0;
     tot_bytes = 0;
 
+    /* One dissection context, record and buffer, reused for every frame */
+    epan_dissect_init(&edt, cf->epan, TRUE, FALSE);
+    /* Don't fake protocols. We need them for the protocol hierarchy */
+    epan_dissect_fake_protocols(&edt, FALSE);
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1500);
+
     for (framenum = 1; framenum <= cf->count; framenum++) {
         frame = frame_data_sequence_find(cf->provider.frames, framenum);
 
@@ -293,7 +307,7 @@ ph_stats_new(capture_file *cf)
             }
 
             /* we don't care about colinfo */
-            if (!process_record(cf, frame, NULL, ps)) {
+            if (!process_record(cf, frame, NULL, &edt, &rec, &buf, ps)) {
                 /*
                  * Give up, and set "stop_flag" so we
                  * just abort rather than popping up
@@ -310,6 +324,10 @@ ph_stats_new(capture_file *cf)
         count++;
     }
 
+    epan_dissect_cleanup(&edt);
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+
     /* We're done calculating the statistics; destroy the progress bar
        if it was created. */
     if (progbar != NULL)
@@ -348,6 +366,9 @@ ph_stats_free(ph_stats_t *ps)
                 stat_node_free, NULL);
         g_node_destroy(ps->stats_tree);
     }
+    if (ps->children) {
+        g_hash_table_destroy(ps->children);
+    }
 
     g_free(ps);
 }
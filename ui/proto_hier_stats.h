@@ -36,6 +36,7 @@ typedef struct {
     GNode	*stats_tree;
     double	first_time;	/* seconds (msec resolution) of first packet */
     double	last_time;	/* seconds (msec resolution) of last packet  */
+    GHashTable	*children;	/* per stats_tree node: its children by protocol id */
 } ph_stats_t;
 
 ph_stats_t *ph_stats_new(capture_file *cf);
@@ -1099,12 +1099,45 @@ void IOGraphDialog::resetAxes()
     iop->replot();
 }
 
+// Find the finest interval in the interval list that evenly divides the
+// current one and still covers the whole capture, so that graphs can be
+// tapped once at that interval and switched to any coarser interval
+// without retapping.
+int IOGraphDialog::baseTapInterval()
+{
+    int interval = ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt();
+    capture_file *cf = cap_file_.capFile();
+
+    // A live capture keeps growing, so stick to the display interval.
+    if (!cf || cf->state != FILE_READ_DONE) {
+        return interval;
+    }
+
+    double elapsed_ms = nstime_to_msec(&cf->elapsed_time);
+    for (int i = 0; i < ui->intervalComboBox->count(); i++) {
+        int candidate = ui->intervalComboBox->itemData(i).toInt();
+        if (candidate <= 0 || candidate > interval || interval % candidate != 0) {
+            continue;
+        }
+        if (elapsed_ms / candidate < max_io_items_ - 1) {
+            return candidate;
+        }
+    }
+    return interval;
+}
+
 void IOGraphDialog::updateStatistics()
 {
     if (!isVisible()) return;
 
     if (need_retap_ && !file_closed_) {
         need_retap_ = false;
+        int tap_interval = baseTapInterval();
+        foreach(IOGraph* iog, ioGraphs_) {
+            if (iog) {
+                iog->setTapInterval(tap_interval);
+            }
+        }
         cap_file_.retapPackets();
         // The user might have closed the window while tapping, which means
         // we might no longer exist.
@@ -1191,8 +1224,7 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
         for (int row = 0; row < uat_model_->rowCount(); row++) {
             IOGraph *iog = ioGraphs_.value(row, NULL);
             if (iog) {
-                iog->setInterval(interval);
-                if (iog->visible()) {
+                if (iog->setInterval(interval) && iog->visible()) {
                     need_retap = true;
                 }
             }
@@ -1201,6 +1233,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 
     if (need_retap) {
         scheduleRetap(true);
+    } else {
+        scheduleRecalc(true);
     }
 
     updateLegend();
@@ -1546,7 +1580,10 @@ IOGraph::IOGraph(QCustomPlot *parent) :
     bars_(NULL),
     val_units_(IOG_ITEM_UNIT_FIRST),
     hf_index_(-1),
-    cur_idx_(-1)
+    interval_(0),
+    tap_interval_(0),
+    cur_idx_(-1),
+    merged_cur_idx_(-1)
 {
     Q_ASSERT(parent_ != NULL);
     graph_ = parent_->addGraph(parent_->xAxis, parent_->yAxis);
@@ -1757,6 +1794,13 @@ void IOGraph::setValueUnits(int val_units)
         val_units_ = (io_graph_item_unit_t)val_units;
 
         if (old_val_units != val_units) {
+            if (val_units_ == IOG_ITEM_UNIT_CALC_LOAD && tap_interval_ != interval_) {
+                // LOAD values can't be merged across intervals.
+                tap_interval_ = interval_;
+                if (visible_) {
+                    emit requestRetap();
+                }
+            }
             setFilter(filter_); // Check config & prime vu field
             if (val_units < IOG_ITEM_UNIT_CALC_SUM) {
                 emit requestRecalc();
@@ -1817,14 +1861,15 @@ double IOGraph::startOffset()
 
 int IOGraph::packetFromTime(double ts)
 {
+    const io_graph_item_t *items = displayItems();
     int idx = ts * 1000 / interval_;
-    if (idx >= 0 && idx < (int) cur_idx_) {
+    if (idx >= 0 && idx < displayCurIdx()) {
         switch (val_units_) {
         case IOG_ITEM_UNIT_CALC_MAX:
         case IOG_ITEM_UNIT_CALC_MIN:
-            return items_[idx].extreme_frame_in_invl;
+            return items[idx].extreme_frame_in_invl;
         default:
-            return items_[idx].last_frame_in_invl;
+            return items[idx].last_frame_in_invl;
         }
     }
     return -1;
@@ -1834,6 +1879,8 @@ void IOGraph::clearAllData()
 {
     cur_idx_ = -1;
     reset_io_graph_items(items_, max_io_items_);
+    merged_items_.clear();
+    merged_cur_idx_ = -1;
     if (graph_) {
         graph_->clearData();
     }
@@ -1851,6 +1898,9 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
     double mavg_cumulated = 0;
     QCPAxis *x_axis = NULL;
 
+    mergeItems();
+    int cur_idx = displayCurIdx();
+
     if (graph_) {
         graph_->clearData();
         x_axis = graph_->keyAxis();
@@ -1860,7 +1910,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
         x_axis = bars_->keyAxis();
     }
 
-    if (moving_avg_period_ > 0 && cur_idx_ >= 0) {
+    if (moving_avg_period_ > 0 && cur_idx >= 0) {
         /* "Warm-up phase" - calculate average on some data not displayed;
          * just to make sure average on leftmost and rightmost displayed
          * values is as reliable as possible
@@ -1876,7 +1926,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
         mavg_in_average_count++;
         for (warmup_interval = interval_;
             ((warmup_interval < (0 + (moving_avg_period_ / 2) * (guint64)interval_)) &&
-             (warmup_interval <= (cur_idx_ * (guint64)interval_)));
+             (warmup_interval <= (cur_idx * (guint64)interval_)));
              warmup_interval += interval_) {
 
             mavg_cumulated += getItemValue((int)warmup_interval / interval_, cap_file);
@@ -1886,7 +1936,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
         mavg_to_add = (unsigned int)warmup_interval;
     }
 
-    for (int i = 0; i <= cur_idx_; i++) {
+    for (int i = 0; i <= cur_idx; i++) {
         double ts = (double) i * interval_ / 1000;
         if (x_axis && x_axis->tickLabelType() == QCPAxis::ltDateTime) {
             ts += start_time_;
@@ -1902,7 +1952,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
                     mavg_cumulated -= getItemValue((int)mavg_to_remove / interval_, cap_file);
                     mavg_to_remove += interval_;
                 }
-                if (mavg_to_add <= (unsigned int) cur_idx_ * interval_) {
+                if (mavg_to_add <= (unsigned int) cur_idx * interval_) {
                     mavg_in_average_count++;
                     mavg_cumulated += getItemValue((int)mavg_to_add / interval_, cap_file);
                     mavg_to_add += interval_;
@@ -2031,9 +2081,48 @@ void IOGraph::reloadValueUnitField()
     }
 }
 
-void IOGraph::setInterval(int interval)
+// Set the display interval. Returns true if the graph has to be retapped,
+// false if the new interval can be built from the items we already have.
+bool IOGraph::setInterval(int interval)
 {
     interval_ = interval;
+    if (tap_interval_ > 0 && interval_ % tap_interval_ == 0 && val_units_ != IOG_ITEM_UNIT_CALC_LOAD) {
+        return false;
+    }
+    tap_interval_ = interval_;
+    return true;
+}
+
+// Set the interval to use for the next tap. It must evenly divide the
+// display interval; if it doesn't, we tap at the display interval.
+void IOGraph::setTapInterval(int tap_interval)
+{
+    if (tap_interval > 0 && interval_ % tap_interval == 0 && val_units_ != IOG_ITEM_UNIT_CALC_LOAD) {
+        tap_interval_ = tap_interval;
+    } else {
+        tap_interval_ = interval_;
+    }
+}
+
+// Combine the tapped items into items for the display interval.
+void IOGraph::mergeItems()
+{
+    if (tap_interval_ == interval_ || tap_interval_ <= 0) {
+        merged_items_.clear();
+        merged_cur_idx_ = -1;
+        return;
+    }
+
+    int ratio = interval_ / tap_interval_;
+    merged_cur_idx_ = cur_idx_ < 0 ? -1 : cur_idx_ / ratio;
+    merged_items_.resize(merged_cur_idx_ + 1);
+    if (merged_cur_idx_ < 0) {
+        return;
+    }
+    reset_io_graph_items(merged_items_.data(), merged_items_.size());
+    for (int i = 0; i <= cur_idx_; i++) {
+        merge_io_graph_item(&merged_items_[i / ratio], &items_[i], hf_index_, val_units_);
+    }
 }
 
 // Get the value at the given interval (idx) for the current value unit.
@@ -2041,7 +2130,7 @@ double IOGraph::getItemValue(int idx, const capture_file *cap_file) const
 {
     g_assert(idx < max_io_items_);
 
-    return get_io_graph_item(items_, val_units_, idx, hf_index_, cap_file, interval_, cur_idx_);
+    return get_io_graph_item(displayItems(), val_units_, idx, hf_index_, cap_file, interval_, displayCurIdx());
 }
 
 // "tap_reset" callback for register_tap_listener
@@ -2062,7 +2151,7 @@ gboolean IOGraph::tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *e
         return FALSE;
     }
 
-    int idx = get_io_graph_index(pinfo, iog->interval_);
+    int idx = get_io_graph_index(pinfo, iog->tap_interval_);
     bool recalc = false;
 
     /* some sanity checks */
@@ -2091,7 +2180,7 @@ gboolean IOGraph::tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *e
         adv_edt = edt;
     }
 
-    if (!update_io_graph_item(iog->items_, idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->interval_)) {
+    if (!update_io_graph_item(iog->items_, idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->tap_interval_)) {
         return FALSE;
     }
 
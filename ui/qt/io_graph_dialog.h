@@ -64,7 +64,8 @@ public:
     const QString valueUnitField() { return vu_field_; }
     void setValueUnitField(const QString &vu_field);
     unsigned int movingAveragePeriod() { return moving_avg_period_; }
-    void setInterval(int interval);
+    bool setInterval(int interval);
+    void setTapInterval(int tap_interval);
     bool addToLegend();
     bool removeFromLegend();
     QCPGraph *graph() { return graph_; }
@@ -72,7 +73,7 @@ public:
     double startOffset();
     int packetFromTime(double ts);
     double getItemValue(int idx, const capture_file *cap_file) const;
-    int maxInterval () const { return cur_idx_; }
+    int maxInterval () const { return displayCurIdx(); }
     QString scaledValueUnit() const { return scaled_value_unit_; }
 
     void clearAllData();
@@ -95,6 +96,9 @@ private:
     static gboolean tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *edt, const void *data);
     static void tapDraw(void *iog_ptr);
 
+    const io_graph_item_t *displayItems() const { return tap_interval_ == interval_ ? items_ : merged_items_.constData(); }
+    int displayCurIdx() const { return tap_interval_ == interval_ ? cur_idx_ : merged_cur_idx_; }
+    void mergeItems();
     void calculateScaledValueUnit();
     template<class DataMap> double maxValueFromGraphData(const DataMap &map);
     template<class DataMap> void scaleGraphData(DataMap &map, int scalar);
@@ -116,8 +120,14 @@ private:
 
     // Cached data. We should be able to change the Y axis without retapping as
     // much as is feasible.
+    // Items are tapped at tap_interval_, which may be finer than interval_.
+    // In that case the displayed items are merged from the tapped ones, so
+    // switching to any multiple of tap_interval_ doesn't require a retap.
+    int tap_interval_;
     io_graph_item_t items_[max_io_items_];
     int cur_idx_;
+    QVector<io_graph_item_t> merged_items_;
+    int merged_cur_idx_;
 };
 
 namespace Ui {
@@ -199,6 +209,7 @@ private:
     void makeCsv(QTextStream &stream) const;
     bool saveCsv(const QString &file_name) const;
     IOGraph *currentActiveGraph() const;
+    int baseTapInterval();
     bool graphIsEnabled(int row) const;
 
 private slots:
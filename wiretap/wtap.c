@@ -1408,6 +1408,144 @@ wtap_read_so_far(wtap *wth)
 	return file_tell_raw(wth->fh);
 }
 
+/*
+ * The length of the data wth->subtype_read() read for a record.
+ */
+static guint32
+wtap_rec_data_len(const wtap_rec *rec)
+{
+	switch (rec->rec_type) {
+
+	case REC_TYPE_PACKET:
+		return rec->rec_header.packet_header.caplen;
+
+	case REC_TYPE_FT_SPECIFIC_EVENT:
+	case REC_TYPE_FT_SPECIFIC_REPORT:
+		return rec->rec_header.ft_specific_header.record_len;
+
+	case REC_TYPE_SYSCALL:
+		return rec->rec_header.syscall_header.event_filelen;
+	}
+	return 0;
+}
+
+void
+wtap_batch_init(wtap_batch *batch, guint size)
+{
+	guint i;
+
+	g_assert(size > 0);
+
+	batch->recs = g_new(wtap_batch_rec, size);
+	for (i = 0; i < size; i++)
+		wtap_rec_init(&batch->recs[i].rec);
+	batch->size = size;
+	batch->count = 0;
+	/* Room for a batch of full-sized Ethernet frames to start with */
+	ws_buffer_init(&batch->data, size * 1514);
+	batch->err = 0;
+	batch->err_info = NULL;
+}
+
+void
+wtap_batch_cleanup(wtap_batch *batch)
+{
+	guint i;
+
+	for (i = 0; i < batch->size; i++) {
+		g_free(batch->recs[i].rec.opt_comment);
+		wtap_rec_cleanup(&batch->recs[i].rec);
+	}
+	g_free(batch->recs);
+	batch->recs = NULL;
+	batch->size = 0;
+	batch->count = 0;
+	ws_buffer_free(&batch->data);
+	g_free(batch->err_info);
+	batch->err_info = NULL;
+}
+
+gboolean
+wtap_read_batch(wtap *wth, wtap_batch *batch, int *err, gchar **err_info)
+{
+	wtap_batch_rec *brec;
+	gint64          data_offset;
+	Buffer          options_buf;
+	guint32         len;
+	guint           i;
+
+	ws_buffer_clean(&batch->data);
+	batch->count = 0;
+
+	if (batch->err != 0) {
+		/* Left over from the previous batch */
+		*err = batch->err;
+		*err_info = batch->err_info;
+		batch->err = 0;
+		batch->err_info = NULL;
+		return FALSE;
+	}
+
+	while (batch->count < batch->size) {
+		if (!wtap_read(wth, err, err_info, &data_offset)) {
+			if (batch->count == 0)
+				return FALSE;
+			batch->err = *err;
+			batch->err_info = *err_info;
+			break;
+		}
+
+		brec = &batch->recs[batch->count++];
+		g_free(brec->rec.opt_comment);
+
+		/* Copy the header. The options buffer is only scratch space
+		   for the readers, so keep our own rather than share it. */
+		options_buf = brec->rec.options_buf;
+		brec->rec = wth->rec;
+		brec->rec.options_buf = options_buf;
+		brec->rec.opt_comment = g_strdup(wth->rec.opt_comment);
+
+		brec->data_offset = data_offset;
+		brec->data_start = ws_buffer_length(&batch->data);
+		len = wtap_rec_data_len(&wth->rec);
+		if (len != 0)
+			ws_buffer_append(&batch->data, ws_buffer_start_ptr(wth->rec_data), len);
+
+		/* The K12 reader keeps the extra info in a buffer of its own
+		   that the next read overwrites, so copy it too. The batch's
+		   buffer may still move, so it's pointed to once it's full. */
+		if (brec->rec.rec_type == REC_TYPE_PACKET &&
+		    brec->rec.rec_header.packet_header.pkt_encap == WTAP_ENCAP_K12 &&
+		    brec->rec.rec_header.packet_header.pseudo_header.k12.extra_info != NULL) {
+			brec->extra_start = ws_buffer_length(&batch->data);
+			ws_buffer_append(&batch->data,
+			    brec->rec.rec_header.packet_header.pseudo_header.k12.extra_info,
+			    brec->rec.rec_header.packet_header.pseudo_header.k12.extra_length);
+		}
+	}
+
+	for (i = 0; i < batch->count; i++) {
+		brec = &batch->recs[i];
+		if (brec->rec.rec_type == REC_TYPE_PACKET &&
+		    brec->rec.rec_header.packet_header.pkt_encap == WTAP_ENCAP_K12 &&
+		    brec->rec.rec_header.packet_header.pseudo_header.k12.extra_info != NULL)
+			brec->rec.rec_header.packet_header.pseudo_header.k12.extra_info =
+			    ws_buffer_start_ptr(&batch->data) + brec->extra_start;
+	}
+
+	*err = 0;
+	*err_info = NULL;
+	return TRUE;
+}
+
+guint8 *
+wtap_batch_get_buf_ptr(wtap_batch *batch, guint index)
+{
+	g_assert(index < batch->count);
+
+	return ws_buffer_start_ptr(&batch->data) + batch->recs[index].data_start;
+}
+
 wtap_rec *
 wtap_get_rec(wtap *wth)
 {
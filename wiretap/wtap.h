@@ -1698,6 +1698,52 @@ WS_DLL_PUBLIC
 gboolean wtap_seek_read(wtap *wth, gint64 seek_off, wtap_rec *rec,
     Buffer *buf, int *err, gchar **err_info);
 
+/** A record read by wtap_read_batch(). */
+typedef struct {
+    wtap_rec rec;           /* the record; the comment is the batch's own copy */
+    gint64   data_offset;   /* as set by wtap_read() */
+    gsize    data_start;    /* where the record's data is in the batch's buffer */
+    gsize    extra_start;   /* where the K12 extra info is in it, if any */
+} wtap_batch_rec;
+
+/** Records read together by wtap_read_batch(). Their headers and data are
+ * copies, as is what a pseudo-header points to that the reader replaces on
+ * every read (the K12 extra info), so they stay valid until the batch is
+ * read into again or cleaned up, and a batch can be handed to another
+ * thread while the next one is read. What a pseudo-header points to that
+ * lasts as long as the file is open (K12 port names, NetMon comments,
+ * the DCT2000 wtap) is shared, so the wtap must stay open for as long as
+ * the records are in use. */
+typedef struct {
+    wtap_batch_rec *recs;
+    guint           size;       /* number of records a batch can hold */
+    guint           count;      /* number of records read */
+    Buffer          data;       /* the data of all of them, back to back */
+    int             err;        /* error deferred to the next read */
+    gchar          *err_info;
+} wtap_batch;
+
+/** Initializes a batch to hold up to size records. */
+WS_DLL_PUBLIC
+void wtap_batch_init(wtap_batch *batch, guint size);
+
+/** Frees what wtap_batch_init() and wtap_read_batch() allocated. */
+WS_DLL_PUBLIC
+void wtap_batch_cleanup(wtap_batch *batch);
+
+/** Reads up to batch->size records into the batch, replacing what it held.
+ * Returns TRUE if at least one record was read. Returns FALSE, with *err
+ * and *err_info set as for wtap_read(), when there are no more records.
+ * If an error occurs after some records have been read, those are
+ * returned first and the error on the next call. */
+WS_DLL_PUBLIC
+gboolean wtap_read_batch(wtap *wth, wtap_batch *batch, int *err,
+    gchar **err_info);
+
+/** Returns the data of the index'th record of a batch. */
+WS_DLL_PUBLIC
+guint8 *wtap_batch_get_buf_ptr(wtap_batch *batch, guint index);
+
 /*** get various information snippets about the current record ***/
 WS_DLL_PUBLIC
 wtap_rec *wtap_get_rec(wtap *wth);
@@ -0,0 +1,247 @@
+/* wtap_batch_test.c
+ * Standalone program to check that reading a capture file with
+ * wtap_read_batch() gives the same records as reading it with wtap_read().
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include <wiretap/wtap.h>
+#include <wsutil/file_util.h>
+
+/* Should have packet comments, so that opt_comment is checked too */
+static const char *capture_path;
+/* The same file cut short in the middle of its last record */
+static char *truncated_path;
+
+/* A record as read by wtap_read() */
+typedef struct {
+	wtap_rec    rec;
+	gint64      data_offset;
+	GByteArray *data;
+} plain_rec;
+
+typedef struct {
+	GPtrArray *recs;
+	int        err;
+} plain_read;
+
+static void
+free_plain_rec(gpointer data)
+{
+	plain_rec *prec = (plain_rec *)data;
+
+	g_free(prec->rec.opt_comment);
+	g_byte_array_free(prec->data, TRUE);
+	g_free(prec);
+}
+
+static void
+read_plain(const char *path, plain_read *plain)
+{
+	wtap      *wth;
+	wtap_rec  *rec;
+	plain_rec *prec;
+	gint64     data_offset;
+	int        err;
+	gchar     *err_info = NULL;
+
+	wth = wtap_open_offline(path, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+	g_assert(wth != NULL);
+
+	plain->recs = g_ptr_array_new_with_free_func(free_plain_rec);
+	while (wtap_read(wth, &err, &err_info, &data_offset)) {
+		rec = wtap_get_rec(wth);
+		prec = g_new0(plain_rec, 1);
+		prec->rec.rec_type = rec->rec_type;
+		prec->rec.presence_flags = rec->presence_flags;
+		prec->rec.ts = rec->ts;
+		prec->rec.tsprec = rec->tsprec;
+		prec->rec.rec_header = rec->rec_header;
+		prec->rec.opt_comment = g_strdup(rec->opt_comment);
+		prec->data_offset = data_offset;
+		prec->data = g_byte_array_new();
+		g_byte_array_append(prec->data, wtap_get_buf_ptr(wth),
+		    rec->rec_type == REC_TYPE_PACKET ? rec->rec_header.packet_header.caplen : 0);
+		g_ptr_array_add(plain->recs, prec);
+	}
+	plain->err = err;
+	g_free(err_info);
+	wtap_close(wth);
+}
+
+static void
+check_batch_rec(wtap *wth, wtap_batch *batch, guint index, const plain_rec *prec)
+{
+	const wtap_rec *rec = &batch->recs[index].rec;
+
+	g_assert_cmpint(batch->recs[index].data_offset, ==, prec->data_offset);
+	g_assert_cmpuint(rec->rec_type, ==, prec->rec.rec_type);
+	g_assert_cmpuint(rec->presence_flags, ==, prec->rec.presence_flags);
+	g_assert_cmpint(rec->ts.secs, ==, prec->rec.ts.secs);
+	g_assert_cmpint(rec->ts.nsecs, ==, prec->rec.ts.nsecs);
+	g_assert_cmpint(rec->tsprec, ==, prec->rec.tsprec);
+	if (rec->rec_type == REC_TYPE_PACKET) {
+		const wtap_packet_header *hdr = &rec->rec_header.packet_header;
+		const wtap_packet_header *phdr = &prec->rec.rec_header.packet_header;
+
+		g_assert_cmpuint(hdr->caplen, ==, phdr->caplen);
+		g_assert_cmpuint(hdr->len, ==, phdr->len);
+		g_assert_cmpint(hdr->pkt_encap, ==, phdr->pkt_encap);
+		g_assert_cmpuint(hdr->interface_id, ==, phdr->interface_id);
+		g_assert_cmpuint(hdr->pack_flags, ==, phdr->pack_flags);
+		g_assert(memcmp(wtap_batch_get_buf_ptr(batch, index), prec->data->data, hdr->caplen) == 0);
+	}
+
+	/* The batch owns its copy of the comment; the reader's one may be
+	   freed or reused by the next read. */
+	g_assert_cmpstr(rec->opt_comment, ==, prec->rec.opt_comment);
+	if (rec->opt_comment != NULL)
+		g_assert(rec->opt_comment != wtap_get_rec(wth)->opt_comment);
+}
+
+static void
+check_batches(const char *path, guint batch_size)
+{
+	plain_read  plain;
+	wtap       *wth;
+	wtap_batch  batch;
+	guint       n = 0, i;
+	int         err;
+	gchar      *err_info = NULL;
+
+	read_plain(path, &plain);
+
+	wth = wtap_open_offline(path, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+	g_assert(wth != NULL);
+
+	wtap_batch_init(&batch, batch_size);
+	while (wtap_read_batch(wth, &batch, &err, &err_info)) {
+		g_assert_cmpint(err, ==, 0);
+		/* Only the last batch can be partial */
+		g_assert_cmpuint(batch.count, ==, MIN(batch_size, plain.recs->len - n));
+		for (i = 0; i < batch.count; i++)
+			check_batch_rec(wth, &batch, i, (plain_rec *)plain.recs->pdata[n + i]);
+		n += batch.count;
+	}
+	g_assert_cmpuint(n, ==, plain.recs->len);
+	/* An error after a partial batch is returned by the next call */
+	g_assert_cmpint(err, ==, plain.err);
+	g_free(err_info);
+	err_info = NULL;
+
+	/* And after that there's nothing left */
+	g_assert(!wtap_read_batch(wth, &batch, &err, &err_info));
+	g_assert_cmpuint(batch.count, ==, 0);
+	g_free(err_info);
+
+	wtap_batch_cleanup(&batch);
+	wtap_close(wth);
+	g_ptr_array_free(plain.recs, TRUE);
+}
+
+static void
+test_batch_size(gconstpointer data)
+{
+	check_batches(capture_path, GPOINTER_TO_UINT(data));
+}
+
+static void
+test_comments(void)
+{
+	plain_read plain;
+	guint      i, comments = 0;
+
+	read_plain(capture_path, &plain);
+	for (i = 0; i < plain.recs->len; i++) {
+		if (((plain_rec *)plain.recs->pdata[i])->rec.opt_comment != NULL)
+			comments++;
+	}
+	g_assert_cmpuint(comments, >, 0);
+	g_ptr_array_free(plain.recs, TRUE);
+}
+
+static void
+test_truncated(void)
+{
+	plain_read plain;
+
+	read_plain(truncated_path, &plain);
+	g_assert_cmpint(plain.err, !=, 0);
+	g_assert_cmpuint(plain.recs->len, >, 1);
+	g_ptr_array_free(plain.recs, TRUE);
+
+	/* Partial batch followed by the error, and a batch that's exactly
+	   filled before it */
+	check_batches(truncated_path, 1);
+	check_batches(truncated_path, 2);
+	check_batches(truncated_path, 64);
+}
+
+int
+main(int argc, char **argv)
+{
+	gchar  *contents;
+	gsize   length;
+	GError *error = NULL;
+	int     fd;
+	int     ret;
+
+	g_test_init(&argc, &argv, NULL);
+
+	if (argc != 2) {
+		g_printerr("Usage: wtap_batch_test [options] <capture file>\n");
+		return 1;
+	}
+	capture_path = argv[1];
+
+	if (!g_file_get_contents(capture_path, &contents, &length, &error) ||
+	    (fd = g_file_open_tmp("wtap_batch_test_XXXXXX", &truncated_path, &error)) == -1) {
+		g_printerr("%s\n", error->message);
+		return 1;
+	}
+	ws_close(fd);
+	if (!g_file_set_contents(truncated_path, contents, length - 8, &error)) {
+		g_printerr("%s\n", error->message);
+		return 1;
+	}
+	g_free(contents);
+
+	wtap_init(FALSE);
+
+	g_test_add_data_func("/wtap/batch/size_1", GUINT_TO_POINTER(1), test_batch_size);
+	g_test_add_data_func("/wtap/batch/size_4", GUINT_TO_POINTER(4), test_batch_size);
+	g_test_add_data_func("/wtap/batch/size_256", GUINT_TO_POINTER(256), test_batch_size);
+	g_test_add_func("/wtap/batch/comments", test_comments);
+	g_test_add_func("/wtap/batch/truncated", test_truncated);
+
+	ret = g_test_run();
+
+	wtap_cleanup();
+	ws_unlink(truncated_path);
+	g_free(truncated_path);
+
+	return ret;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -44,18 +44,29 @@ json_puts_string(FILE *fp, const char *str)
         "u0010", "u0011", "u0012", "u0013", "u0014", "u0015", "u0016", "u0017", "u0018", "u0019", "u001a", "u001b", "u001c", "u001d", "u001e", "u001f"
     };
 
+    const char *run = str;
+
     fputc('"', fp);
-    for (int i = 0; str[i]; i++) {
-        if ((guint)str[i] < 0x20) {
-            fputc('\\', fp);
-            fputs(json_cntrl[(guint)str[i]], fp);
+    for (const char *p = str; *p; p++) {
+        guchar c = (guchar)*p;
+
+        if (c >= 0x20 && c != '\\' && c != '"') {
+            continue;
+        }
+
+        /* Write the characters that need no escaping in one go. */
+        if (p != run) {
+            fwrite(run, 1, p - run, fp);
+        }
+        fputc('\\', fp);
+        if (c < 0x20) {
+            fputs(json_cntrl[c], fp);
         } else {
-            if (str[i] == '\\' || str[i] == '"') {
-                fputc('\\', fp);
-            }
-            fputc(str[i], fp);
+            fputc(c, fp);
         }
+        run = p + 1;
     }
+    fputs(run, fp);
     fputc('"', fp);
 }
 
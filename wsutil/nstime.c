@@ -149,10 +149,51 @@ int nstime_cmp (const nstime_t *a, const nstime_t *b )
     if (a->secs == b->secs) {
         return a->nsecs - b->nsecs;
     } else {
-        return (int) (a->secs - b->secs);
+        /* Don't return the (truncated) difference, it can overflow an int. */
+        return (a->secs > b->secs) ? 1 : -1;
     }
 }
 
+/*
+ * function: nstime_to_packed
+ * converts nstime to a signed 64-bit nanosecond count
+ */
+
+#define PACKED_SECS_MAX (G_MAXINT64 / NS_PER_S - 1)
+#define PACKED_SECS_MIN (G_MININT64 / NS_PER_S + 1)
+
+gint64 nstime_to_packed(const nstime_t *nstime)
+{
+    if (G_UNLIKELY(nstime_is_unset(nstime))) {
+        return NSTIME_PACKED_UNSET;
+    }
+    if (G_UNLIKELY((gint64)nstime->secs > PACKED_SECS_MAX)) {
+        return G_MAXINT64;
+    }
+    if (G_UNLIKELY((gint64)nstime->secs < PACKED_SECS_MIN)) {
+        /* Keep it distinct from NSTIME_PACKED_UNSET. */
+        return G_MININT64 + 1;
+    }
+    return (gint64)nstime->secs * NS_PER_S + nstime->nsecs;
+}
+
+/*
+ * function: nstime_from_packed
+ * converts a signed 64-bit nanosecond count to nstime
+ */
+
+void nstime_from_packed(nstime_t *nstime, gint64 packed)
+{
+    if (G_UNLIKELY(packed == NSTIME_PACKED_UNSET)) {
+        nstime_set_unset(nstime);
+        return;
+    }
+    /* C99 division truncates towards zero, so both parts get the same sign
+     * as in the result of nstime_delta(). */
+    nstime->secs = (time_t)(packed / NS_PER_S);
+    nstime->nsecs = (int)(packed % NS_PER_S);
+}
+
 /*
  * function: nstime_to_msec
  * converts nstime to double, time base is milli seconds
@@ -104,6 +104,20 @@ WS_DLL_PUBLIC void nstime_sum(nstime_t *sum, const nstime_t *b, const nstime_t *
  */
 WS_DLL_PUBLIC int nstime_cmp (const nstime_t *a, const nstime_t *b );
 
+/** Packed time stamps are a signed 64-bit count of nanoseconds relative to
+ * the UN*X epoch, which covers the years 1678 to 2262.  They can be stored
+ * contiguously and compared or subtracted with plain integer arithmetic.
+ * An unset nstime_t is packed as NSTIME_PACKED_UNSET, which is less than
+ * all other packed values, matching nstime_cmp().
+ */
+#define NSTIME_PACKED_UNSET G_MININT64
+
+/** converts nstime to a packed time stamp, out-of-range values saturate */
+WS_DLL_PUBLIC gint64 nstime_to_packed(const nstime_t *nstime);
+
+/** converts a packed time stamp back to nstime */
+WS_DLL_PUBLIC void nstime_from_packed(nstime_t *nstime, gint64 packed);
+
 /** converts nstime to double, time base is milli seconds */
 WS_DLL_PUBLIC double nstime_to_msec(const nstime_t *nstime);
 